@@ -46,6 +46,12 @@ export const useApp = defineStore('app', () => {
       window.postMessage({ id: data.id, state: 'success' })
       return
     }
+
+    if (data.method === 'getHashes') {
+      const result = await bridge.getHashes('lua')
+      window.postMessage({ id: data.id, state: 'success', result })
+      return
+    }
   })
 
   return { showPropFields, isMapping }
@@ -1,15 +1,24 @@
 import { Message } from '@miwos/osc'
 import { type MessageArgValue } from '@miwos/osc/src/types'
-import crc from 'crc/calculators/crc16xmodem'
+import crc32 from 'crc/calculators/crc32'
 import type { Transport } from './Transport'
+import type { DirEntry, FileHash } from './types'
 import type { PathParams } from './utils'
 import {
   asArray,
+  createDirTree,
   createRequestId,
   EventEmitter,
   parseDirList,
 } from './utils'
 
+// Files are uploaded in chunks of this size (an SD sector), with up to
+// `chunkWindow` chunks waiting for their acknowledgement at any time.
+const chunkSize = 512
+const chunkWindow = 8
+// How often a timed out upload or hash list is resumed before giving up.
+const transferRetries = 3
+
 export interface BridgeOptions {
   responseTimeout?: number
   debug?: boolean
@@ -69,25 +78,51 @@ export class Bridge extends EventEmitter {
   }
 
   async readFile(fileName: string) {
-    const buffer = (await this.request('/file/read', fileName)) as Uint8Array
-    const content = new TextDecoder().decode(buffer).slice('File:'.length)
-    return content
+    const id = createRequestId()
+    // The device responds with the file's size and then sends the content in
+    // chunks (`/file/data`), spread over several of its loops. Listen right
+    // away, the first chunks might arrive together with the response.
+    const chunks = this.receiveChunks(id)
+    try {
+      await this.sendMessage('/file/read', [id, fileName])
+      const size = (await this.waitForResponse(id)) as number
+      const buffer = await chunks.complete(size)
+      return new TextDecoder().decode(buffer)
+    } catch (error) {
+      chunks.cancel()
+      throw error
+    }
   }
 
   async writeFile(fileName: string, content: string) {
     if (!content.length) throw new Error("file can't be empty")
 
-    const id = createRequestId()
     const buffer = new TextEncoder().encode(content)
-    const checkSum = crc(buffer)
+    const checkSum = crc32(buffer)
 
     const parts = fileName.split('/')
     const baseName = parts.pop() ?? fileName
     const dirName = parts.join('/')
 
-    await this.sendMessage('/raw/file/write', [id, dirName, baseName, checkSum])
-    await this.transport.write(buffer)
-    return this.waitForResponse(id)
+    for (let attempt = 1; ; attempt++) {
+      // Opening the same upload again resumes it, the device responds with the
+      // offset it has received so far. A lost or failed open is retried just
+      // like a timed out upload.
+      const id = createRequestId()
+      const args = [id, dirName, baseName, buffer.length, checkSum]
+
+      try {
+        await this.sendMessage('/file/open', args)
+        const offset = (await this.waitForResponse(id)) as number
+        await this.sendChunks(id, buffer, offset)
+      } catch (error) {
+        if (attempt < transferRetries) continue
+        throw error
+      }
+
+      await this.sendMessage('/file/close', id)
+      return this.waitForResponse(id)
+    }
   }
 
   removeFile(fileName: string) {
@@ -99,15 +134,41 @@ export class Bridge extends EventEmitter {
   }
 
   async getDir(dirName: string, recursive = false) {
-    const buffer = await this.request('/dir/list', [dirName, recursive ? 1 : 0])
-    const content = new TextDecoder().decode(buffer as any)
-
-    // To prevent a timeout while waiting for an empty dir list, the device
-    // always has to send something (a leading 'Dir:'). If we only received this
-    // and nothing else the directory is empty.
-    if (content === 'Dir:') return []
+    const entries: DirEntry[] = []
+
+    // Big directories are listed in chunks, each ending with the cursor to
+    // request the next chunk with (or zero once the list is complete).
+    let cursor = 0
+    do {
+      const args = [dirName, recursive ? 1 : 0, cursor]
+      const chunk = (await this.request('/dir/list', args)) as Uint8Array
+      const list = parseDirList(chunk)
+      entries.push(...list.entries)
+      cursor = list.cursor
+    } while (cursor)
+
+    return createDirTree(entries)
+  }
 
-    return parseDirList(content.slice('Dir:'.length))
+  // The size and CRC32 of every file in the directory and its subdirectories.
+  // The device caches the hashes, so this is cheap unless files have changed.
+  async getHashes(dirName: string) {
+    const hashes: FileHash[] = []
+    // Each hash comes with the cursor to continue after it, so a timed out
+    // request is resumed instead of hashing everything again.
+    let cursor = 0
+    for (let attempt = 1; ; attempt++) {
+      try {
+        await this.receiveHashes(dirName, cursor, (hash, nextCursor) => {
+          hashes.push(hash)
+          cursor = nextCursor
+        })
+        return hashes
+      } catch (error) {
+        if (attempt < transferRetries) continue
+        throw error
+      }
+    }
   }
 
   private sendMessage(name: string, args: MessageArgValue | MessageArgValue[]) {
@@ -116,6 +177,170 @@ export class Bridge extends EventEmitter {
     return this.transport.write(data)
   }
 
+  private sendChunks(id: number, buffer: Uint8Array, offset: number) {
+    return new Promise<void>((resolve, reject) => {
+      if (offset >= buffer.length) return resolve()
+
+      // Everything before `received` has been acknowledged by the device.
+      let received = offset
+      let next = offset
+      let timeout: ReturnType<typeof setTimeout>
+
+      const sendWindow = () => {
+        const end = Math.min(buffer.length, received + chunkWindow * chunkSize)
+        while (next < end) {
+          const chunk = buffer.subarray(next, next + chunkSize)
+          this.sendMessage('/file/chunk', [id, next, chunk, crc32(chunk)])
+          next += chunk.length
+        }
+      }
+
+      const cleanup = () => {
+        clearTimeout(timeout)
+        this.off('/file/ack', handler)
+        this.off('/file/nack', handler)
+      }
+
+      const restartTimeout = () => {
+        clearTimeout(timeout)
+        timeout = this.startResponseTimeout((error) => {
+          cleanup()
+          reject(error)
+        })
+      }
+
+      // A nack means a chunk was corrupted (or lost), so everything from the
+      // device's offset on has to be sent again.
+      const handler = (message: Message) => {
+        const [ackId, offset] = message.args as number[]
+        if (ackId !== id) return
+
+        received = offset
+        if (message.address === '/file/nack') next = offset
+
+        if (received >= buffer.length) {
+          cleanup()
+          resolve()
+        } else {
+          restartTimeout()
+          sendWindow()
+        }
+      }
+
+      this.on('/file/ack', handler)
+      this.on('/file/nack', handler)
+      restartTimeout()
+      sendWindow()
+    })
+  }
+
+  private receiveChunks(id: number) {
+    const buffers: Uint8Array[] = []
+    let received = 0
+    let handleChunk = () => {}
+
+    const handler = (message: Message) => {
+      const [chunkId, offset, chunk] = message.args as [
+        number,
+        number,
+        Uint8Array
+      ]
+      if (chunkId !== id || offset !== received) return
+      // The chunk is only a view of the received data.
+      buffers.push(chunk.slice())
+      received += chunk.length
+      handleChunk()
+    }
+    this.on('/file/data', handler)
+
+    const cancel = () => this.off('/file/data', handler)
+
+    const complete = (size: number) =>
+      new Promise<Uint8Array>((resolve, reject) => {
+        let timeout: ReturnType<typeof setTimeout>
+
+        handleChunk = () => {
+          clearTimeout(timeout)
+          if (received < size) {
+            timeout = this.startResponseTimeout((error) => {
+              cancel()
+              reject(error)
+            })
+            return
+          }
+
+          cancel()
+          const buffer = new Uint8Array(size)
+          let offset = 0
+          for (const chunk of buffers) {
+            buffer.set(chunk, offset)
+            offset += chunk.length
+          }
+          resolve(buffer)
+        }
+        handleChunk()
+      })
+
+    return { complete, cancel }
+  }
+
+  private receiveHashes(
+    dirName: string,
+    cursor: number,
+    handleHash: (hash: FileHash, cursor: number) => void
+  ) {
+    return new Promise<void>((resolve, reject) => {
+      const id = createRequestId()
+      let timeout: ReturnType<typeof setTimeout>
+
+      const cleanup = () => {
+        clearTimeout(timeout)
+        this.off('/dir/hash', handler)
+        this.off('/dir/hashes/end', handler)
+      }
+
+      const fail = (error: Error) => {
+        cleanup()
+        reject(error)
+      }
+
+      const restartTimeout = () => {
+        clearTimeout(timeout)
+        timeout = this.startResponseTimeout(fail)
+      }
+
+      // The device hashes the files spread over several of its loops, so the
+      // timeout only applies to the time between two hashes.
+      const handler = (message: Message) => {
+        const [hashId, nextCursor, size, hash, path] = message.args as [
+          number,
+          number,
+          number,
+          number,
+          string
+        ]
+        if (hashId !== id) return
+
+        if (message.address === '/dir/hashes/end') {
+          cleanup()
+          resolve()
+        } else {
+          // The CRC32 is sent as a (signed) int32.
+          handleHash({ path, size, hash: hash >>> 0 }, nextCursor)
+          restartTimeout()
+        }
+      }
+
+      // Listen right away, the first hashes might arrive together with the
+      // response.
+      this.on('/dir/hash', handler)
+      this.on('/dir/hashes/end', handler)
+      restartTimeout()
+      this.sendMessage('/dir/hashes', [id, dirName, cursor])
+      this.waitForResponse(id).catch(fail)
+    })
+  }
+
   private waitForResponse(id: number): Promise<MessageArgValue> {
     return new Promise((resolve, reject) => {
       const timeout = this.startResponseTimeout(reject)
@@ -8,7 +8,19 @@ export interface Message {
 export interface DirItem {
   name: string
   type: 'directory' | 'file'
+  size: number
+  modified: Date
   children?: DirItem[]
 }
 
+export interface DirEntry extends Omit<DirItem, 'children'> {
+  depth: number
+}
+
 export type Dir = DirItem[]
+
+export interface FileHash {
+  path: string // Relative to the requested directory.
+  size: number
+  hash: number // CRC32
+}
@@ -1,42 +1,68 @@
-import type { Dir, DirItem } from '../types'
+import type { Dir, DirEntry, DirItem } from '../types'
 
-const getDepth = (name: string) => {
-  let count = 0
-  for (const char of name) {
-    if (char !== ' ') break
-    count++
-  }
-  // Each new depth is represented by two spaces.
-  return count / 2
+// FAT timestamps are local time with a two second resolution, the date in the
+// upper 16 bits.
+const parseFatDateTime = (value: number) => {
+  const date = value >>> 16
+  const time = value & 0xffff
+  return new Date(
+    (date >> 9) + 1980,
+    ((date >> 5) & 0x0f) - 1,
+    date & 0x1f,
+    time >> 11,
+    (time >> 5) & 0x3f,
+    (time & 0x1f) * 2
+  )
 }
 
-export const parseDirList = (dirList: string): Dir => {
-  const items: DirItem[] = []
-  let depth = 0
-  let openDirs: Record<number, DirItem> = {}
+// A chunk of a dir list is a sequence of binary entries (depth, flags, size,
+// modify date and time, name length and name), followed by the cursor of the
+// next chunk (or zero if the list is complete). See `FileSystem::listDir()`
+// in the bridge's firmware.
+export const parseDirList = (chunk: Uint8Array) => {
+  if (chunk.length < 4) throw new Error('Invalid dir list, missing cursor')
 
-  const lines = dirList.split('\n')
-  for (const line of lines) {
-    if (!line) continue
+  const view = new DataView(chunk.buffer, chunk.byteOffset, chunk.byteLength)
+  const decoder = new TextDecoder()
+  const entries: DirEntry[] = []
+  const end = chunk.length - 4
+
+  let offset = 0
+  while (offset < end) {
+    const nameLength = view.getUint8(offset + 10)
+    const nameStart = offset + 11
+    entries.push({
+      depth: view.getUint8(offset),
+      type: view.getUint8(offset + 1) & 1 ? 'directory' : 'file',
+      size: view.getUint32(offset + 2),
+      modified: parseFatDateTime(view.getUint32(offset + 6)),
+      name: decoder.decode(chunk.subarray(nameStart, nameStart + nameLength)),
+    })
+    offset = nameStart + nameLength
+  }
 
-    const path = line.trim()
-    const isDir = path.endsWith('/')
-    const type = isDir ? 'directory' : 'file'
-    const name = isDir ? path.slice(0, -1) : path
+  if (offset !== end) throw new Error('Invalid dir list, truncated entry')
 
-    const item: DirItem = { name, type }
+  return { entries, cursor: view.getUint32(end) }
+}
+
+// Entries are listed depth first, so each entry belongs to the last directory
+// one level above it.
+export const createDirTree = (entries: DirEntry[]): Dir => {
+  const items: DirItem[] = []
+  const openDirs: Record<number, DirItem> = {}
 
-    // Use `line` because in `path` the tabs have already been trimmed.
-    depth = getDepth(line)
+  for (const { depth, ...entry } of entries) {
+    const item: DirItem = entry
 
-    if (isDir) {
+    if (item.type === 'directory') {
       item.children = []
       openDirs[depth] = item
     }
 
-    const parent = depth === 0 ? items : openDirs[depth - 1].children
+    const parent = depth === 0 ? items : openDirs[depth - 1]?.children
     if (!parent) {
-      throw new Error(`Invalid dir list, no parent folder found for '${path}'`)
+      throw new Error(`Invalid dir list, no parent folder found for '${item.name}'`)
     }
 
     parent.push(item)
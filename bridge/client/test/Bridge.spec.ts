@@ -1,7 +1,7 @@
 import { afterAll, beforeAll, describe, expect, it } from 'vitest'
 import { Bridge } from '../src'
 import { NodeSerialTransport } from '../src/NodeSerialTransport'
-import { dirIncludes, randomString } from './utils'
+import { dirIncludes, dirNames, randomString } from './utils'
 
 const testDir = '__test__'
 const path = 'COM5'
@@ -38,6 +38,13 @@ describe('Bridge', () => {
     expect(await bridge.readFile(file)).toBe(content)
   })
 
+  it('reads a big file in chunks', async () => {
+    const content = randomString(20000)
+    const file = `${testDir}/big.txt`
+    await bridge.writeFile(file, content)
+    expect(await bridge.readFile(file)).toBe(content)
+  })
+
   it('handles empty files', async () => {
     const file = `${testDir}/test.txt`
     await expect(bridge.writeFile(file, '')).rejects.toThrowError(
@@ -58,7 +65,7 @@ describe('Bridge', () => {
   })
 
   it('lists a directory', async () => {
-    expect(await bridge.getDir(testDir)).toMatchSnapshot()
+    expect(dirNames(await bridge.getDir(testDir))).toMatchSnapshot()
   })
 
   it('handles empty directories', async () => {
@@ -92,6 +99,16 @@ describe('Bridge', () => {
       await bridge.writeFile(`${testDir}/many/file-${i}.txt`, content)
     }
     const dir = await bridge.getDir(`${testDir}/many`)
-    expect(dir).toMatchSnapshot()
+    expect(dirNames(dir)).toMatchSnapshot()
+    expect(dir.every((item) => item.size === content.length)).toBeTruthy()
+  })
+
+  it('lists big directories in chunks', async () => {
+    const count = 50
+    for (let i = 0; i < count; i++) {
+      await bridge.writeFile(`${testDir}/big/nested/file-${i}.txt`, 'test')
+    }
+    const dir = await bridge.getDir(`${testDir}/big`, true)
+    expect(dir[0].children?.length).toBe(count)
   })
 })
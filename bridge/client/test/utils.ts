@@ -3,6 +3,13 @@ import { Dir } from '../src/types'
 export const dirIncludes = (dir: Dir, name: string) =>
   dir.find((v) => v.name === name)
 
+// Sizes and modify dates differ between test runs, so they can't be part of a
+// snapshot.
+export const dirNames = (dir: Dir): unknown[] =>
+  dir.map(({ name, type, children }) =>
+    children ? { name, type, children: dirNames(children) } : { name, type }
+  )
+
 export const randomString = (length: number) => {
   length = length || 5
   const charSet =
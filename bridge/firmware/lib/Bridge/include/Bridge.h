@@ -2,6 +2,7 @@
 #define Bridge_h
 
 #include "Logger.h"
+#include "OscInput.h"
 #include "SlipSerial.h"
 #include <Arduino.h>
 #include <OSCMessage.h>
@@ -9,16 +10,18 @@
 namespace Bridge {
   enum ReadSerialMode { ReadSerialModeOsc, ReadSerialModeRaw };
   enum ResponseType { ResponseSuccess, ResponseError };
-  typedef OSCMessage Data;
+  typedef OscInput Data;
   typedef uint16_t RequestId;
 
-  typedef void (*RawInputHandler)(byte b);
+  typedef void (*RawInputHandler)(const uint8_t *data, uint16_t length);
   typedef void (*RawInputEndHandler)();
+  typedef void (*UpdateHandler)();
 
-  typedef void (*MethodHandler)(OSCMessage &data);
+  typedef void (*MethodHandler)(Data &data);
   struct Method {
     const char *name;
     MethodHandler handler;
+    Method *next; // The next method with the same name.
   };
 
   namespace {
@@ -26,10 +29,36 @@ namespace Bridge {
     ReadSerialMode readSerialMode = ReadSerialModeOsc;
     RawInputHandler handleRawInput;
     RawInputEndHandler handleRawInputEnd;
+    UpdateHandler handleUpdate;
 
-    static const byte maxMethods = 32;
-    Method methods[maxMethods];
-    byte methodsCount = 0;
+    // The number of bytes that may be read and written per update (zero for
+    // no limit), so big transfers are spread over several loops instead of
+    // stalling midi, timers and displays until they are done.
+    uint32_t ioBudget = 0;
+    uint32_t ioBudgetLeft = 0;
+
+    // The methods are stored in a tree of their names' segments, so an
+    // address is resolved segment by segment instead of matching it against
+    // each method. Literal segments are compared by their hash first.
+    struct Node {
+      const char *segment; // Points into the method's name.
+      uint16_t length;
+      uint32_t hash;
+      bool isPattern;  // The segment contains a `*` or `?`.
+      Method *methods; // The methods whose name ends here.
+      Node *children;
+      Node *next; // The next sibling.
+    };
+    Node root = {};
+
+    // A whole (decoded) packet is received into this buffer and the OSC
+    // message is parsed in place, see `OscInput`.
+    static const uint16_t maxPacketSize = 1024;
+    uint8_t packet[maxPacketSize];
+    uint16_t packetLength = 0;
+    bool isPacketTooLong = false;
+    bool isRawInputStarted = false;
+    Data oscInput;
 
     const char *getResponseAddress(ResponseType type, bool isRaw) {
       if (type == ResponseSuccess) {
@@ -48,27 +77,169 @@ namespace Bridge {
       message.empty();
     }
 
-    void handleOscInput(OSCMessage &oscInput) {
-      char addressStart[6] = {0};
-      oscInput.getAddress(addressStart, 0, 5);
-      if (!strcmp(addressStart, "/raw/")) {
+    uint32_t hashSegment(const char *segment, uint16_t length) {
+      // FNV-1a
+      uint32_t hash = 2166136261;
+      for (uint16_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)segment[i];
+        hash *= 16777619;
+      }
+      return hash;
+    }
+
+    const char *getSegmentEnd(const char *segment) {
+      while (*segment != '\0' && *segment != '/') segment++;
+      return segment;
+    }
+
+    // Like OSC's pattern matching, but only with `*` and `?`.
+    bool matchSegment(const char *pattern, uint16_t patternLength,
+        const char *segment, uint16_t length) {
+      for (; patternLength > 0; pattern++, patternLength--) {
+        if (*pattern == '*') {
+          // Match any (possibly empty) rest of the segment.
+          for (uint16_t skip = 0; skip <= length; skip++) {
+            if (matchSegment(pattern + 1, patternLength - 1, segment + skip,
+                    length - skip))
+              return true;
+          }
+          return false;
+        }
+        if (length == 0) return false;
+        if (*pattern != '?' && *pattern != *segment) return false;
+        segment++;
+        length--;
+      }
+      return length == 0;
+    }
+
+    bool matchNode(Node *node, const char *segment, uint16_t length,
+        uint32_t hash) {
+      if (node->isPattern)
+        return matchSegment(node->segment, node->length, segment, length);
+      return node->hash == hash && node->length == length &&
+             !memcmp(node->segment, segment, length);
+    }
+
+    // Call the methods of all nodes that match the rest of the address (which
+    // starts with a `/`).
+    void dispatch(Node *node, const char *address, Data &data) {
+      if (*address == '\0') {
+        for (Method *method = node->methods; method; method = method->next)
+          method->handler(data);
+        return;
+      }
+
+      const char *segment = address + 1;
+      const char *end = getSegmentEnd(segment);
+      uint16_t length = end - segment;
+      uint32_t hash = hashSegment(segment, length);
+
+      for (Node *child = node->children; child; child = child->next) {
+        if (matchNode(child, segment, length, hash)) dispatch(child, end, data);
+      }
+    }
+
+    void handleOscInput(Data &data) {
+      const char *address = data.getAddress();
+      if (!strncmp(address, "/raw/", 5)) {
         readSerialMode = ReadSerialModeRaw;
+        isRawInputStarted = false;
       }
 
-      for (byte i = 0; i < methodsCount; i++) {
-        oscInput.dispatch(methods[i].name, methods[i].handler);
+      dispatch(&root, address, data);
+    }
+
+    void handlePacket() {
+      if (isPacketTooLong) {
+        Logger::error("OSC input too long");
+      } else if (!oscInput.parse(packet, packetLength)) {
+        Logger::error("OSC input error");
+      } else {
+        handleOscInput(oscInput);
       }
+      packetLength = 0;
+      isPacketTooLong = false;
+    }
+
+    // Pass the raw input on in chunks (as large as the packet buffer). The raw
+    // packet is framed like any other, so its leading `eot` starts it and the
+    // next one ends it, even if the payload is empty. Returns false if there
+    // is no input left.
+    bool readRawInput() {
+      bool isEnd;
+      size_t count = serial->readPacket(packet, maxPacketSize, isEnd);
+      ioBudgetLeft -= min((uint32_t)count, ioBudgetLeft);
+      if (count > 0) {
+        // Also accept a payload without a leading `eot`.
+        isRawInputStarted = true;
+        if (handleRawInput != NULL) handleRawInput(packet, count);
+      }
+
+      if (isEnd && !isRawInputStarted) {
+        isRawInputStarted = true;
+      } else if (isEnd) {
+        if (handleRawInputEnd != NULL) handleRawInputEnd();
+        readSerialMode = ReadSerialModeOsc;
+      }
+      return count > 0 || isEnd;
+    }
+
+    // Returns false if there is no input left.
+    bool readOscInput() {
+      bool isEnd;
+      size_t count;
+      if (isPacketTooLong) {
+        // Drop the rest of the packet.
+        count = serial->readPacket(packet, maxPacketSize, isEnd);
+      } else if (packetLength == maxPacketSize) {
+        // The buffer is full, so the packet only fits if it ends right here.
+        uint8_t next;
+        count = serial->readPacket(&next, 1, isEnd);
+        isPacketTooLong = count > 0;
+      } else {
+        count = serial->readPacket(
+            packet + packetLength, maxPacketSize - packetLength, isEnd);
+        packetLength += count;
+      }
+      ioBudgetLeft -= min((uint32_t)count, ioBudgetLeft);
+
+      if (isEnd && (packetLength > 0 || isPacketTooLong)) handlePacket();
+      return count > 0 || isEnd;
     }
 
   }; // namespace
 
-  void addMethod(const char *name, MethodHandler method) {
-    methodsCount++;
-    if (methodsCount < maxMethods) {
-      methods[methodsCount - 1] = {name, method};
-    } else {
-      Logger::error("maximum amount of methods reached");
+  // The name has to stay valid, it isn't copied. Segments can be patterns
+  // with `*` and `?`, e.g. `/n/*/*`.
+  void addMethod(const char *name, MethodHandler handler) {
+    Node *node = &root;
+    const char *segment = name;
+
+    while (*segment == '/') {
+      segment++;
+      const char *end = getSegmentEnd(segment);
+      uint16_t length = end - segment;
+
+      Node **child = &node->children;
+      while (*child != NULL && ((*child)->length != length ||
+                                   memcmp((*child)->segment, segment, length)))
+        child = &(*child)->next;
+
+      if (*child == NULL) {
+        bool isPattern = memchr(segment, '*', length) != NULL ||
+                         memchr(segment, '?', length) != NULL;
+        *child = new Node{segment, length, hashSegment(segment, length),
+            isPattern, NULL, NULL, NULL};
+      }
+
+      node = *child;
+      segment = end;
     }
+
+    Method **method = &node->methods;
+    while (*method != NULL) method = &(*method)->next;
+    *method = new Method{name, handler, NULL};
   }
 
   void respond(RequestId id) {
@@ -118,32 +289,35 @@ namespace Bridge {
     Logger::begin(serial);
   }
 
+  // Handle the packets that have been received so far, as far as the I/O
+  // budget allows. The rest (and a packet that hasn't been received
+  // completely) is kept for the next update. Then lets ongoing transfers
+  // continue with the remaining budget and sends the coalesced output once it
+  // is due (see `SlipSerial`).
   void update() {
-    OSCMessage oscInput;
-
-    if (serial->available()) {
-      while (!serial->endOfPacket()) {
-        while (serial->available()) {
-          int c = serial->read();
-          if (readSerialMode == ReadSerialModeOsc) {
-            oscInput.fill(c);
-          } else if (readSerialMode == ReadSerialModeRaw) {
-            if (handleRawInput != NULL) handleRawInput(c);
-          }
-        }
-      }
+    ioBudgetLeft = ioBudget > 0 ? ioBudget : UINT32_MAX;
 
-      if (readSerialMode == ReadSerialModeOsc) {
-        if (oscInput.hasError()) {
-          Logger::error("OSC input error");
-        } else {
-          handleOscInput(oscInput);
-        }
-      } else if (readSerialMode == ReadSerialModeRaw) {
-        if (handleRawInputEnd != NULL) handleRawInputEnd();
-        readSerialMode = ReadSerialModeOsc;
-      }
+    bool hasInput = true;
+    while (hasInput && ioBudgetLeft > 0) {
+      hasInput = readSerialMode == ReadSerialModeRaw ? readRawInput()
+                                                       : readOscInput();
     }
+
+    if (handleUpdate != NULL) handleUpdate();
+    serial->update();
+  }
+
+  void setIoBudget(uint32_t bytes) { ioBudget = bytes; }
+
+  uint32_t getIoBudgetLeft() { return ioBudgetLeft; }
+
+  // Claims up to `bytes` of the current update's I/O budget. Returns the
+  // number of bytes that may be used, which is zero once the budget is
+  // exhausted.
+  uint32_t takeIoBudget(uint32_t bytes) {
+    uint32_t count = min(bytes, ioBudgetLeft);
+    ioBudgetLeft -= count;
+    return count;
   }
 
   bool validateData(Data &data, const char *types, byte numArguments) {
@@ -177,6 +351,9 @@ namespace Bridge {
   void onRawInputEnd(RawInputEndHandler handler) {
     handleRawInputEnd = handler;
   }
+  // Called on each update, for work (like file transfers) that is spread over
+  // several updates.
+  void onUpdate(UpdateHandler handler) { handleUpdate = handler; }
 }; // namespace Bridge
 
 #endif
\ No newline at end of file
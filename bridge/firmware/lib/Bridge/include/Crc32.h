@@ -0,0 +1,48 @@
+#ifndef Crc32_h
+#define Crc32_h
+
+#include <Arduino.h>
+
+/**
+ * The standard (IEEE 802.3) CRC32, as calculated by `crc32` of the `crc` npm
+ * package the client uses.
+ */
+class Crc32 {
+private:
+  uint32_t crc = 0xFFFFFFFF;
+
+  static uint32_t getTableEntry(uint8_t index) {
+    static uint32_t table[256];
+    static bool isInitialized = false;
+
+    if (!isInitialized) {
+      for (uint16_t i = 0; i < 256; i++) {
+        uint32_t entry = i;
+        for (byte bit = 0; bit < 8; bit++)
+          entry = entry & 1 ? (entry >> 1) ^ 0xEDB88320 : entry >> 1;
+        table[i] = entry;
+      }
+      isInitialized = true;
+    }
+
+    return table[index];
+  }
+
+public:
+  void reset() { crc = 0xFFFFFFFF; }
+
+  void add(const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++)
+      crc = getTableEntry((crc ^ data[i]) & 0xFF) ^ (crc >> 8);
+  }
+
+  uint32_t getCrc() { return crc ^ 0xFFFFFFFF; }
+
+  static uint32_t calculate(const uint8_t *data, size_t length) {
+    Crc32 crc;
+    crc.add(data, length);
+    return crc.getCrc();
+  }
+};
+
+#endif
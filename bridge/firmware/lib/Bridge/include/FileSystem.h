@@ -2,8 +2,8 @@
 #define BridgeFileSystem_h
 
 #include "Bridge.h"
+#include "Crc32.h"
 #include "SlipSerial.h"
-#include <CRC16.h>
 #include <SdFat.h>
 
 namespace FileSystem {
@@ -23,67 +23,546 @@ namespace FileSystem {
   namespace {
     FatFile file;
     SdFat sd;
-    CRC16 crc;
-    uint16_t checkSum;
-    RequestId requestId;
 
     // 256 ist the actual max file name length. But we have to make sure that
     // there is enough room for the temp prefix `__`.
     static const uint16_t maxFileNameLength = 254;
     static const uint16_t maxTempFileNameLength = 256;
-    char tempFileName[maxFileNameLength];
     char dirName[maxFileNameLength];
     char baseName[maxFileNameLength];
     char fileName[maxFileNameLength];
 
-    void startWriteFile(Data &data) {
-      // Save the request id so we can use it to respond in `endWrite()`.
-      RequestId id = requestId = data.getInt(0);
-      data.getString(1, dirName);
-      data.getString(2, baseName);
-      checkSum = data.getInt(3);
+    // A file is uploaded in chunks (`/file/chunk`) of up to `chunkSize` bytes
+    // with their own CRC32. Each chunk is acknowledged with the offset up to
+    // which the file has been received (`/file/ack`), so the client can keep
+    // a window of chunks in flight. A chunk with a wrong CRC32 or offset is
+    // answered once with `/file/nack` and the offset the client has to resend
+    // from. Re-opening the same upload (e.g. after a timeout) resumes at the
+    // received offset instead of starting over. If writing to the SD card
+    // fails, the rest of the upload is only received and `/file/close`
+    // responds with an error.
+    static const uint16_t chunkSize = 512;
+
+    struct Upload {
+      RequestId id;
+      uint32_t size;
+      uint32_t checkSum;
+      uint32_t offset; // Received so far.
+      bool isOpen;
+      bool isRewinding; // A nack has been sent, ignore chunks until resent.
+      bool hasWriteError;
+    };
+    Upload upload = {};
+    FatFile uploadFile;
+    Crc32 uploadCrc;
+    char uploadFileName[maxFileNameLength];
+    char uploadTempFileName[maxTempFileNameLength];
+
+    // Files are written and read in blocks of whole SD sectors, so SdFat can
+    // transfer them directly instead of going through its sector cache.
+    static const uint16_t bufferSize = 4 * 512;
+    uint8_t writeBuffer[bufferSize];
+    uint16_t writeLength = 0;
+    uint8_t readBuffer[bufferSize];
+
+    // A file is read (`/file/read`) by responding with its size and then
+    // sending its content in `/file/data` messages, as much per update as the
+    // bridge's I/O budget allows. So reading a big file doesn't block the loop
+    // and other messages can be sent in between.
+    struct Download {
+      RequestId id;
+      uint32_t size;
+      uint32_t offset; // Sent so far.
+      bool isOpen;
+    };
+    Download download = {};
+    FatFile downloadFile;
+
+    void flushWriteBuffer() {
+      if (writeLength == 0) return;
+      bool isWritten = !upload.hasWriteError &&
+                       uploadFile.write(writeBuffer, writeLength) == writeLength;
+      if (!isWritten) upload.hasWriteError = true;
+      writeLength = 0;
+    }
+
+    void bufferWrite(const uint8_t *data, uint16_t length) {
+      while (length > 0) {
+        uint16_t count =
+            min(length, (uint16_t)(sizeof(writeBuffer) - writeLength));
+        memcpy(writeBuffer + writeLength, data, count);
+        writeLength += count;
+        data += count;
+        length -= count;
+        if (writeLength == sizeof(writeBuffer)) flushWriteBuffer();
+      }
+    }
+
+    void closeUpload() {
+      writeLength = 0;
+      uploadFile.close();
+      sd.remove(uploadTempFileName);
+      upload.isOpen = false;
+    }
+
+    // The size and CRC32 of files are cached in a manifest on the SD card, so
+    // `/dir/hashes` only has to read files that changed. Entries are keyed by
+    // a hash of the file's path and are updated when an upload is completed
+    // or invalidated when a file is written or removed by other means. An
+    // entry is only used if the file's size and modify time still match, in
+    // case it was changed elsewhere (e.g. with the SD card in a computer).
+    // Changes are saved in the next update (see `update()`), so many of them
+    // are written at once.
+    static const char *manifestFileName = "/.hashes";
+    static const uint16_t maxHashEntries = 1024;
+
+    struct HashEntry {
+      uint64_t key;
+      uint32_t size;
+      uint32_t modified; // FAT date (in the upper 16 bits) and time.
+      uint32_t checkSum;
+    };
+    HashEntry hashEntries[maxHashEntries];
+    uint16_t hashEntriesCount = 0;
+    bool isManifestLoaded = false;
+    bool isManifestChanged = false;
+
+    // FNV-1a, ignoring leading slashes so `/lua/a.lua` and `lua/a.lua` match
+    // and case, like FAT does.
+    uint64_t getPathKey(const char *path) {
+      while (*path == '/') path++;
+      uint64_t key = 0xCBF29CE484222325;
+      for (; *path; path++)
+        key = (key ^ (uint8_t)tolower((uint8_t)*path)) * 0x100000001B3;
+      return key;
+    }
+
+    void loadManifest() {
+      if (isManifestLoaded) return;
+      isManifestLoaded = true;
+      hashEntriesCount = 0;
+
+      FatFile manifest;
+      if (!manifest.open(manifestFileName, O_READ)) return;
+      int length = manifest.read(hashEntries, sizeof(hashEntries));
+      hashEntriesCount = length > 0 ? length / sizeof(HashEntry) : 0;
+      manifest.close();
+    }
+
+    void saveManifest() {
+      if (!isManifestChanged) return;
+      isManifestChanged = false;
+
+      FatFile manifest;
+      if (!manifest.open(manifestFileName, O_WRITE | O_CREAT | O_TRUNC))
+        return error("failed to save hash manifest");
+      manifest.write(hashEntries, hashEntriesCount * sizeof(HashEntry));
+      manifest.close();
+    }
 
-      if (!validateData(data, "issi", 4)) return respondError(id);
+    HashEntry *findHash(uint64_t key) {
+      for (uint16_t i = 0; i < hashEntriesCount; i++) {
+        if (hashEntries[i].key == key) return &hashEntries[i];
+      }
+      return NULL;
+    }
+
+    uint32_t getModified(FatFile &file) {
+      uint16_t date = 0, time = 0;
+      file.getModifyDateTime(&date, &time);
+      return ((uint32_t)date << 16) | time;
+    }
+
+    void setHash(
+        const char *path, uint32_t size, uint32_t modified, uint32_t checkSum) {
+      loadManifest();
+      uint64_t key = getPathKey(path);
+      HashEntry *entry = findHash(key);
+      if (entry == NULL) {
+        // If the manifest is full, the file's hash simply isn't cached.
+        if (hashEntriesCount >= maxHashEntries) return;
+        entry = &hashEntries[hashEntriesCount++];
+      }
+      *entry = {key, size, modified, checkSum};
+      isManifestChanged = true;
+    }
+
+    // Returns whether the file had a cached hash.
+    bool removeHash(const char *path) {
+      loadManifest();
+      HashEntry *entry = findHash(getPathKey(path));
+      if (entry == NULL) return false;
+      *entry = hashEntries[--hashEntriesCount];
+      isManifestChanged = true;
+      return true;
+    }
+
+    void clearHashes() {
+      hashEntriesCount = 0;
+      isManifestLoaded = true;
+      isManifestChanged = false;
+      sd.remove(manifestFileName);
+    }
+
+    // A directory tree is walked depth first by a traversal that is kept
+    // open between requests, so a big tree can be handled in chunks (see
+    // `listDir()` and `listHashes()`). Only if the client asks for another
+    // cursor (e.g. after a timeout) the tree has to be walked again up to
+    // that cursor.
+    static const uint8_t maxTraversalDepth = 16;
+
+    struct Traversal {
+      // The open directories, followed by the current entry.
+      FatFile files[maxTraversalDepth + 1];
+      // The current entry's path and where the names of each open
+      // directory's entries start in it.
+      char path[maxFileNameLength];
+      uint16_t nameStarts[maxTraversalDepth];
+      char dirName[maxFileNameLength];
+      uint32_t cursor; // Entries visited so far.
+      uint8_t openDirs;
+      bool isRecursive;
+    };
+
+    void closeTraversal(Traversal &traversal) {
+      for (uint8_t i = 0; i <= traversal.openDirs; i++)
+        traversal.files[i].close();
+      traversal.openDirs = 0;
+    }
+
+    // Opens the next entry (depth first) into
+    // `traversal.files[traversal.openDirs]` and its path into
+    // `traversal.path`, or returns false if the traversal is complete.
+    bool openNextEntry(Traversal &traversal) {
+      while (traversal.openDirs > 0) {
+        uint8_t depth = traversal.openDirs - 1;
+        FatFile &dir = traversal.files[depth];
+        FatFile &entry = traversal.files[depth + 1];
+        char *name = traversal.path + traversal.nameStarts[depth];
+        uint16_t nameSize = maxFileNameLength - traversal.nameStarts[depth];
+        while (entry.openNext(&dir, O_READ)) {
+          bool isVisible = entry.getName(name, nameSize) > 0 &&
+                           !entry.isHidden() && name[0] != '.';
+          if (isVisible) return true;
+          entry.close();
+        }
+        dir.close();
+        traversal.openDirs--;
+      }
+      return false;
+    }
+
+    // Closes the current entry, unless it is a directory to descend into.
+    void closeEntry(Traversal &traversal) {
+      uint8_t depth = traversal.openDirs;
+      FatFile &entry = traversal.files[depth];
+      uint16_t length = strlen(traversal.path);
+      bool isDescending = traversal.isRecursive && entry.isDir() &&
+                          depth < maxTraversalDepth &&
+                          length + 2 < maxFileNameLength;
+      if (isDescending) {
+        traversal.path[length++] = '/';
+        traversal.path[length] = '\0';
+        traversal.nameStarts[depth] = length;
+        traversal.openDirs++;
+      } else {
+        entry.close();
+      }
+      traversal.cursor++;
+    }
+
+    bool isTraversalAt(
+        Traversal &traversal, const char *dirName, bool isRecursive,
+        uint32_t cursor) {
+      return cursor > 0 && traversal.openDirs > 0 &&
+             traversal.cursor == cursor &&
+             traversal.isRecursive == isRecursive &&
+             !strcmp(traversal.dirName, dirName);
+    }
+
+    bool openTraversal(
+        Traversal &traversal, const char *dirName, bool isRecursive,
+        uint32_t cursor) {
+      closeTraversal(traversal);
+      traversal.cursor = 0;
+      traversal.isRecursive = isRecursive;
+      strcpy(traversal.dirName, dirName);
+
+      uint16_t length = strlen(dirName);
+      if (length + 2 >= maxFileNameLength) return false;
+      strcpy(traversal.path, dirName);
+      if (length > 0 && dirName[length - 1] != '/')
+        traversal.path[length++] = '/';
+      traversal.path[length] = '\0';
+      traversal.nameStarts[0] = length;
+
+      FatFile &dir = traversal.files[0];
+      if (!dir.open(dirName)) return false;
+      if (!dir.isDir()) {
+        dir.close();
+        return false;
+      }
+      traversal.openDirs = 1;
+
+      // Walk the tree up to the requested cursor.
+      while (traversal.cursor < cursor && openNextEntry(traversal)) {
+        closeEntry(traversal);
+      }
+      return true;
+    }
+
+    // A directory is listed in chunks of up to `listChunkEntries` entries, so
+    // a large (recursive) listing doesn't block the loop for the whole
+    // traversal. Each chunk is a raw response of binary entries (see
+    // `sendListEntry()`) followed by the cursor to request the next chunk
+    // with, or zero if the listing is complete.
+    static const uint8_t listChunkEntries = 32;
+    Traversal listing;
+
+    void writeUint32(uint32_t value) {
+      uint8_t bytes[4] = {
+          (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8),
+          (uint8_t)value};
+      serial->write(bytes, sizeof(bytes));
+    }
+
+    // An entry is its depth (0 for the listed directory's children), flags
+    // (bit 0: is a directory), size, FAT modify date and time (date in the
+    // upper 16 bits), name length and name. Numbers are big-endian, like in
+    // OSC.
+    void sendListEntry() {
+      uint8_t depth = listing.openDirs - 1;
+      FatFile &entry = listing.files[listing.openDirs];
+      const char *name = listing.path + listing.nameStarts[depth];
+      uint8_t nameLength = min(strlen(name), (size_t)255);
+
+      uint8_t header[2] = {depth, (uint8_t)(entry.isDir() ? 1 : 0)};
+      serial->write(header, sizeof(header));
+      writeUint32(entry.isDir() ? 0 : entry.fileSize());
+      writeUint32(getModified(entry));
+      serial->write(nameLength);
+      serial->write((const uint8_t *)name, nameLength);
+    }
+
+    // The hashes of a directory's files (`/dir/hashes`) are sent in a
+    // `/dir/hash` message per file, with the cursor to continue after that
+    // file, and a final `/dir/hashes/end`. Files without a cached hash are
+    // read as much per update as the bridge's I/O budget allows, like a
+    // download, so hashing a big tree doesn't block the loop.
+    struct Hashing {
+      RequestId id;
+      uint32_t size;
+      uint32_t modified;
+      uint32_t offset; // Read so far.
+      bool isActive;
+      bool isReading; // The current entry's CRC32 is being calculated.
+    };
+    Hashing hashing = {};
+    Traversal hashTraversal;
+    Crc32 hashCrc;
+    // Visiting an entry without reading it takes this many bytes of the I/O
+    // budget, so big trees with cached hashes are spread over updates too.
+    static const uint16_t hashEntryCost = 64;
+
+    void sendHash(uint32_t checkSum) {
+      OSCMessage message("/dir/hash");
+      message.add((int32_t)hashing.id);
+      message.add((int32_t)hashTraversal.cursor);
+      message.add((int32_t)hashing.size);
+      message.add((int32_t)checkSum);
+      // The path relative to the requested directory.
+      message.add(hashTraversal.path + hashTraversal.nameStarts[0]);
+      Bridge::sendOscMessage(message);
+    }
+
+    void finishHashing() {
+      OSCMessage message("/dir/hashes/end");
+      message.add((int32_t)hashing.id);
+      Bridge::sendOscMessage(message);
+
+      closeTraversal(hashTraversal);
+      hashing.isActive = false;
+      hashing.isReading = false;
+    }
+
+    void updateHashing() {
+      Traversal &traversal = hashTraversal;
+      while (hashing.isActive) {
+        if (hashing.isReading) {
+          FatFile &entry = traversal.files[traversal.openDirs];
+          uint32_t blockLeft = bufferSize - hashing.offset % bufferSize;
+          uint32_t count = Bridge::takeIoBudget(blockLeft);
+          if (count == 0) return;
+
+          int length = entry.read(readBuffer, count);
+          if (length < 0) {
+            // The file is left out, so the client treats it as missing.
+            error("failed to read file");
+            hashing.isReading = false;
+            closeEntry(traversal);
+            continue;
+          }
+
+          hashCrc.add(readBuffer, length);
+          hashing.offset += length;
+          if (length > 0 && hashing.offset < hashing.size) continue;
+
+          uint32_t checkSum = hashCrc.getCrc();
+          setHash(traversal.path, hashing.size, hashing.modified, checkSum);
+          hashing.isReading = false;
+          closeEntry(traversal);
+          sendHash(checkSum);
+          continue;
+        }
+
+        if (Bridge::takeIoBudget(hashEntryCost) == 0) return;
+        if (!openNextEntry(traversal)) return finishHashing();
+
+        FatFile &entry = traversal.files[traversal.openDirs];
+        const char *name =
+            traversal.path + traversal.nameStarts[traversal.openDirs - 1];
+        // Skip directories (their files follow) and upload temp files.
+        if (entry.isDir() || !strncmp(name, "__", 2)) {
+          closeEntry(traversal);
+          continue;
+        }
+
+        hashing.size = entry.fileSize();
+        hashing.modified = getModified(entry);
+        HashEntry *cached = findHash(getPathKey(traversal.path));
+        bool isCached = cached != NULL && cached->size == hashing.size &&
+                        cached->modified == hashing.modified;
+        if (isCached) {
+          closeEntry(traversal);
+          sendHash(cached->checkSum);
+          continue;
+        }
+
+        hashCrc.reset();
+        hashing.offset = 0;
+        hashing.isReading = true;
+      }
+    }
+
+    void sendUploadOffset(const char *address) {
+      OSCMessage message(address);
+      message.add((int32_t)upload.id);
+      message.add((int32_t)upload.offset);
+      Bridge::sendOscMessage(message);
+    }
+
+    void openFile(Data &data) {
+      RequestId id = data.getInt(0);
+      data.getString(1, dirName, maxFileNameLength);
+      data.getString(2, baseName, maxFileNameLength);
+      uint32_t size = data.getInt(3);
+      uint32_t checkSum = data.getInt(4);
+
+      if (!validateData(data, "issii", 5)) return respondError(id);
 
       strcpy(fileName, dirName);
       strcat(fileName, "/");
       strcat(fileName, baseName);
 
-      strcpy(tempFileName, dirName);
-      strcat(tempFileName, "/__");
-      strcat(tempFileName, baseName);
+      bool isResumed = upload.isOpen && upload.size == size &&
+                       upload.checkSum == checkSum && !upload.hasWriteError &&
+                       !strcmp(uploadFileName, fileName);
+      if (isResumed) {
+        upload.id = id;
+        upload.isRewinding = false;
+        return respond(id, (int32_t)upload.offset);
+      }
+
+      if (upload.isOpen) closeUpload();
+
+      strcpy(uploadFileName, fileName);
+      strcpy(uploadTempFileName, dirName);
+      strcat(uploadTempFileName, "/__");
+      strcat(uploadTempFileName, baseName);
 
       // Always override old content with new content.
-      if (sd.exists(tempFileName)) sd.remove(tempFileName);
+      if (sd.exists(uploadTempFileName)) sd.remove(uploadTempFileName);
 
       // Create all missing parent directories.
       sd.mkdir(dirName);
 
-      file.open(tempFileName, FILE_WRITE);
-      crc.reset();
+      if (!uploadFile.open(uploadTempFileName, FILE_WRITE))
+        return respondError(id, "failed to open file for writing");
 
-      if (!file) {
-        Bridge::respondError(id, "failed to open file for writing");
-      }
+      upload = {id, size, checkSum, 0, true, false, false};
+      uploadCrc.reset();
+      writeLength = 0;
+      respond(id, (int32_t)0);
     }
 
-    void writeFile(uint8_t b) {
-      file.write(b);
-      crc.add(b);
+    void writeChunk(Data &data) {
+      RequestId id = data.getInt(0);
+      uint32_t offset = data.getInt(1);
+      uint32_t length;
+      const uint8_t *chunk = data.getBlob(2, length);
+      uint32_t checkSum = data.getInt(3);
+
+      if (!validateData(data, "iibi", 4)) return;
+      if (!upload.isOpen || id != upload.id) return;
+
+      bool isValid = offset == upload.offset && length <= chunkSize &&
+                     offset + length <= upload.size &&
+                     Crc32::calculate(chunk, length) == checkSum;
+
+      if (!isValid) {
+        if (!upload.isRewinding) sendUploadOffset("/file/nack");
+        upload.isRewinding = true;
+        return;
+      }
+
+      bufferWrite(chunk, length);
+      uploadCrc.add(chunk, length);
+      upload.offset += length;
+      upload.isRewinding = false;
+      sendUploadOffset("/file/ack");
     }
 
-    void endWriteFile() {
-      file.close();
+    void closeFile(Data &data) {
+      RequestId id = data.getInt(0);
+      if (!validateData(data, "i", 1)) return respondError(id);
+
+      if (!upload.isOpen || id != upload.id)
+        return respondError(id, "no open upload");
 
-      if (crc.getCRC() == checkSum) {
-        if (sd.exists(fileName)) sd.remove(fileName);
-        sd.rename(tempFileName, fileName);
-        respond(requestId);
-      } else {
-        respondError(requestId, "checksum isn't matching");
+      if (upload.offset != upload.size) {
+        closeUpload();
+        return respondError(id, "file is incomplete");
+      }
+
+      if (uploadCrc.getCrc() != upload.checkSum) {
+        closeUpload();
+        return respondError(id, "checksum isn't matching");
+      }
+
+      flushWriteBuffer();
+      if (upload.hasWriteError) {
+        closeUpload();
+        return respondError(id, "failed to write file");
       }
 
-      sd.remove(tempFileName);
+      uploadFile.close();
+      if (sd.exists(uploadFileName)) sd.remove(uploadFileName);
+      sd.rename(uploadTempFileName, uploadFileName);
+      upload.isOpen = false;
+
+      FatFile uploaded;
+      if (uploaded.open(uploadFileName, O_READ)) {
+        setHash(
+            uploadFileName, upload.size, getModified(uploaded),
+            upload.checkSum);
+        uploaded.close();
+      }
+      respond(id);
+    }
+
+    void closeDownload() {
+      downloadFile.close();
+      download.isOpen = false;
     }
 
     void readFile(Data &data) {
@@ -92,23 +571,47 @@ namespace FileSystem {
 
       if (!validateData(data, "is", 2)) return respondError(id);
 
+      // Only one file is read at a time.
+      if (download.isOpen) closeDownload();
+
       if (!sd.exists(fileName)) return respondError(id, "file doesn't exist");
 
-      file.open(fileName, O_READ);
-      if (!file) return respondError(id, "failed to open file");
+      if (!downloadFile.open(fileName, O_READ))
+        return respondError(id, "failed to open file");
 
-      beginRespond(id);
-      // Always send something, in case the file is empty (and therefore the
-      // client would timeout waiting for the content). We can ignore this in
-      // the client.
-      Bridge::serial->print("File:");
+      uint32_t size = downloadFile.fileSize();
+      download = {id, size, 0, true};
+      respond(id, (int32_t)size);
+      if (size == 0) closeDownload();
+    }
 
-      while (file.available()) {
-        serial->write(file.read());
+    void updateDownload() {
+      bool hasSent = false;
+      while (download.isOpen) {
+        // Read whole blocks. The rest of the budget is only used for a
+        // partial block if it's all there is (e.g. if the budget is smaller
+        // than a block), the next read is realigned to the block boundary.
+        uint32_t blockLeft = bufferSize - download.offset % bufferSize;
+        if (hasSent && Bridge::getIoBudgetLeft() < blockLeft) return;
+        uint32_t count = Bridge::takeIoBudget(blockLeft);
+        if (count == 0) return;
+
+        int length = downloadFile.read(readBuffer, count);
+        if (length <= 0) {
+          error("failed to read file");
+          return closeDownload();
+        }
+
+        OSCMessage message("/file/data");
+        message.add((int32_t)download.id);
+        message.add((int32_t)download.offset);
+        message.add(readBuffer, length);
+        Bridge::sendOscMessage(message);
+        hasSent = true;
+
+        download.offset += length;
+        if (download.offset >= download.size) closeDownload();
       }
-      endRespond();
-
-      file.close();
     }
 
     void removeFile(Data &data) {
@@ -117,7 +620,8 @@ namespace FileSystem {
 
       if (!validateData(data, "is", 2)) return respondError(id);
 
-      if (!sd.remove(fileName)) respondError(id);
+      if (!sd.remove(fileName)) return respondError(id);
+      removeHash(fileName);
 
       respond(id);
     }
@@ -130,6 +634,8 @@ namespace FileSystem {
 
       if (sd.exists(dirName)) {
         file.open(dirName);
+        // The manifest doesn't know which files were inside the directory.
+        clearHashes();
         if (!file.rmRfStar()) return respondError(id);
       }
 
@@ -138,43 +644,79 @@ namespace FileSystem {
 
     void listDir(Data &data) {
       RequestId id = data.getInt(0);
-      data.getString(1, fileName, maxFileNameLength);
-      int isRecursive = data.getInt(2);
-
-      if (!validateData(data, "isi", 3)) return respondError(id);
+      data.getString(1, dirName, maxFileNameLength);
+      bool isRecursive = data.getInt(2);
+      uint32_t cursor = data.getInt(3);
 
-      file.open(fileName);
-      if (!file) return respondError(id, "failed to open file");
+      if (!validateData(data, "isii", 4)) return respondError(id);
 
-      if (!file.isDir()) return respondError(id, "not a directory");
+      bool isContinued = isTraversalAt(listing, dirName, isRecursive, cursor);
+      if (!isContinued && !openTraversal(listing, dirName, isRecursive, cursor))
+        return respondError(id, "failed to open directory");
 
       beginRespond(id);
-      // Always send something, in case the directory is empty (and therefore
-      // the client would timeout waiting for the listing). We can ignore this
-      // in the client.
-      Bridge::serial->print("Dir:");
-
-      file.ls(Bridge::serial, isRecursive ? LS_R : 0, 0);
+      for (uint8_t i = 0; i < listChunkEntries; i++) {
+        if (!openNextEntry(listing)) break;
+        sendListEntry();
+        closeEntry(listing);
+      }
+      // The cursor also makes sure that we always send something, even if
+      // the directory is empty (otherwise the client would timeout waiting).
+      writeUint32(listing.openDirs > 0 ? listing.cursor : 0);
       endRespond();
-
-      file.close();
     }
 
+    void listHashes(Data &data) {
+      RequestId id = data.getInt(0);
+      data.getString(1, dirName, maxFileNameLength);
+      uint32_t cursor = data.getInt(2);
+
+      if (!validateData(data, "isi", 3)) return respondError(id);
+
+      // Only one directory is hashed at a time. A request for the cursor the
+      // hashing is at (e.g. after a timeout) continues it, even in the middle
+      // of reading a file.
+      bool isContinued = isTraversalAt(hashTraversal, dirName, true, cursor);
+      if (!isContinued) {
+        hashing.isActive = false;
+        hashing.isReading = false;
+        if (!openTraversal(hashTraversal, dirName, true, cursor))
+          return respondError(id, "failed to open directory");
+      }
+
+      loadManifest();
+      hashing.id = id;
+      hashing.isActive = true;
+      respond(id);
+    }
   } // namespace
 
+  // Has to be called whenever a file is written without `/file/open`, so its
+  // cached hash doesn't get stale.
+  void invalidateHash(const char *fileName) { removeHash(fileName); }
+
+  void update() {
+    updateDownload();
+    updateHashing();
+    // A directory's hashes are saved once they are all known.
+    if (!hashing.isActive) saveManifest();
+  }
+
   void begin() {
     if (!sd.begin(SdioConfig(FIFO_SDIO))) {
       error("SD initialization failed");
     }
 
-    Bridge::onRawInput(writeFile);
-    Bridge::onRawInputEnd(endWriteFile);
+    Bridge::onUpdate(update);
 
     Bridge::addMethod("/file/read", readFile);
     Bridge::addMethod("/file/remove", removeFile);
-    Bridge::addMethod("/raw/file/write", startWriteFile);
+    Bridge::addMethod("/file/open", openFile);
+    Bridge::addMethod("/file/chunk", writeChunk);
+    Bridge::addMethod("/file/close", closeFile);
     Bridge::addMethod("/dir/list", listDir);
     Bridge::addMethod("/dir/remove", removeDir);
+    Bridge::addMethod("/dir/hashes", listHashes);
   }
 } // namespace FileSystem
 
@@ -0,0 +1,169 @@
+#ifndef OscInput_h
+#define OscInput_h
+
+#include <Arduino.h>
+
+/**
+ * A received OSC message, parsed in place: the address, the type tags and the
+ * arguments are only views into the packet buffer, nothing is copied. The
+ * getters match the ones of `OSCMessage`, so method handlers work the same.
+ * The buffer has to stay untouched as long as the message is used.
+ */
+class OscInput {
+public:
+  static const byte maxArguments = 32;
+
+private:
+  const uint8_t *packet = NULL;
+  const char *address = NULL;
+  const char *types = NULL; // Without the leading comma.
+  uint16_t offsets[maxArguments];
+  byte argumentsCount = 0;
+
+  // OSC strings (and blobs) are padded with zeros to a multiple of four.
+  static uint16_t pad(uint16_t length) { return (length + 3) & ~3; }
+
+  // Returns the padded length of the string at `offset` or zero if it isn't
+  // terminated within the packet.
+  static uint16_t getStringSize(
+      const uint8_t *packet, uint16_t offset, uint16_t length) {
+    const void *end = memchr(packet + offset, '\0', length - offset);
+    if (end == NULL) return 0;
+    return pad((const uint8_t *)end - (packet + offset) + 1);
+  }
+
+  static uint32_t readUint32(const uint8_t *data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8) | data[3];
+  }
+
+  const uint8_t *getArgument(int i, char type) {
+    if (i < 0 || i >= argumentsCount || types[i] != type) return NULL;
+    return packet + offsets[i];
+  }
+
+public:
+  // Returns false if the packet isn't a valid OSC message (bundles aren't
+  // supported).
+  bool parse(const uint8_t *packet, uint16_t length) {
+    this->packet = packet;
+    address = types = NULL;
+    argumentsCount = 0;
+
+    if (length < 4 || length % 4 != 0 || packet[0] != '/') return false;
+    uint16_t offset = getStringSize(packet, 0, length);
+    if (offset == 0) return false;
+    address = (const char *)packet;
+
+    // Type tags are optional, some (older) implementations omit them.
+    if (offset == length) {
+      types = "";
+      return true;
+    }
+
+    if (packet[offset] != ',') return false;
+    uint16_t typesSize = getStringSize(packet, offset, length);
+    if (typesSize == 0) return false;
+    types = (const char *)packet + offset + 1;
+    offset += typesSize;
+
+    for (const char *type = types; *type; type++) {
+      if (argumentsCount >= maxArguments) return false;
+      offsets[argumentsCount++] = offset;
+
+      uint16_t size = 0;
+      switch (*type) {
+        case 'i':
+        case 'f':
+          size = 4;
+          break;
+        case 'h':
+        case 'd':
+        case 't':
+          size = 8;
+          break;
+        case 's':
+          if (offset >= length) return false;
+          size = getStringSize(packet, offset, length);
+          if (size == 0) return false;
+          break;
+        case 'b':
+          if (offset + 4 > length) return false;
+          if (readUint32(packet + offset) > length) return false;
+          size = 4 + pad(readUint32(packet + offset));
+          break;
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I':
+          break;
+        default:
+          return false;
+      }
+
+      if (offset + size > length) return false;
+      offset += size;
+    }
+    return true;
+  }
+
+  const char *getAddress() { return address; }
+
+  int getAddress(char *buffer, int offset, int length) {
+    if (length <= 0) return 0;
+    int addressLength = strlen(address);
+    offset = min(max(offset, 0), addressLength);
+    int count = min(addressLength - offset, length - 1);
+    memcpy(buffer, address + offset, count);
+    buffer[count] = '\0';
+    return count;
+  }
+
+  int size() { return argumentsCount; }
+
+  char getType(int i) { return i >= 0 && i < argumentsCount ? types[i] : '\0'; }
+
+  int32_t getInt(int i) {
+    const uint8_t *data = getArgument(i, 'i');
+    return data != NULL ? (int32_t)readUint32(data) : 0;
+  }
+
+  float getFloat(int i) {
+    const uint8_t *data = getArgument(i, 'f');
+    if (data == NULL) return 0;
+    uint32_t bits = readUint32(data);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // The string itself (inside the packet) or NULL.
+  const char *getString(int i) { return (const char *)getArgument(i, 's'); }
+
+  int getString(int i, char *buffer, int length) {
+    const char *string = getString(i);
+    if (length == 0) return 0;
+    if (string == NULL) string = "";
+    strncpy(buffer, string, length);
+    buffer[length - 1] = '\0';
+    return strlen(buffer);
+  }
+
+  int getString(int i, char *buffer) {
+    const char *string = getString(i);
+    if (string == NULL) string = "";
+    strcpy(buffer, string);
+    return strlen(buffer);
+  }
+
+  // The blob's data (inside the packet) or NULL.
+  const uint8_t *getBlob(int i, uint32_t &length) {
+    const uint8_t *data = getArgument(i, 'b');
+    length = data != NULL ? readUint32(data) : 0;
+    return data != NULL ? data + 4 : NULL;
+  }
+
+  bool getBoolean(int i) { return getType(i) == 'T'; }
+};
+
+#endif
@@ -15,144 +15,154 @@ static const uint8_t slipEscEsc = 0335;
  * Slightly modified version of the SlipEncodedSerial class in CNMAT's OSC
  * library for arduino.
  * https://github.com/CNMAT/OSC
+ *
+ * Input is decoded a whole packet at a time (see `readPacket()`) instead of
+ * byte by byte with `available()`, `peek()` and `read()`. Output is escaped
+ * into a buffer that is handed to the usb serial in bulk, either at the end of
+ * each packet or, if coalescing is enabled, after a short interval (or once
+ * the buffer is full) so many small packets share one usb transfer.
  */
 class SlipSerial : public Stream {
 private:
-  enum RState { CHAR, FIRSTEOT, SECONDEOT, SLIPESC } rstate;
   usb_serial_class *serial;
 
-public:
-  SlipSerial(usb_serial_class &serial) {
-    this->serial = &serial;
-    rstate = CHAR;
+  // Raw (still encoded) input, read from the usb serial in one go.
+  static const uint8_t inputSize = 64;
+  uint8_t input[inputSize];
+  uint8_t inputStart = 0;
+  uint8_t inputEnd = 0;
+  bool isEscaped = false;
+
+  bool fillInput() {
+    if (inputStart < inputEnd) return true;
+    int count = min(serial->available(), (int)inputSize);
+    if (count <= 0) return false;
+    inputStart = 0;
+    inputEnd = serial->readBytes((char *)input, count);
+    return inputEnd > 0;
   }
 
-  void begin(unsigned long baudrate) { serial->begin(baudrate); }
+  // Encoded output, the size of a (high speed) usb packet.
+  static const uint16_t outputSize = 512;
+  uint8_t output[outputSize];
+  uint16_t outputLength = 0;
+  uint32_t coalesceInterval = 0; // μs, zero sends each packet right away.
+  uint32_t pendingTime = 0;
+  bool isPending = false;
+
+  void flushOutput() {
+    if (outputLength == 0) return;
+    serial->write(output, outputLength);
+    outputLength = 0;
+  }
 
-  int available() {
-  back:
-    int count = serial->available();
+  void put(uint8_t b) {
+    if (outputLength == outputSize) flushOutput();
+    output[outputLength++] = b;
+  }
 
-    if (count == 0) {
-      return 0;
+  void putEscaped(uint8_t b) {
+    if (b == eot) {
+      put(slipEsc);
+      put(slipEscEnd);
+    } else if (b == slipEsc) {
+      put(slipEsc);
+      put(slipEscEsc);
+    } else {
+      put(b);
     }
+  }
+
+public:
+  SlipSerial(usb_serial_class &serial) { this->serial = &serial; }
+
+  void begin(unsigned long baudrate) { serial->begin(baudrate); }
 
-    if (rstate == CHAR) {
-      uint8_t c = serial->peek();
-      if (c == slipEsc) {
-        rstate = SLIPESC;
-        serial->read();
-        goto back;
+  // Decode the available input into `buffer` until the packet ends, the buffer
+  // is full or there is no input left. Returns the number of decoded bytes and
+  // sets `isEnd` if the packet is complete. Packets are framed with an `eot`
+  // at both ends, so empty packets have to be ignored by the caller.
+  size_t readPacket(uint8_t *buffer, size_t size, bool &isEnd) {
+    size_t count = 0;
+    isEnd = false;
+
+    while (count < size && fillInput()) {
+      uint8_t c = input[inputStart++];
+      if (isEscaped) {
+        isEscaped = false;
+        if (c == slipEscEnd) {
+          c = eot;
+        } else if (c == slipEscEsc) {
+          c = slipEsc;
+        }
+      } else if (c == slipEsc) {
+        isEscaped = true;
+        continue;
       } else if (c == eot) {
-        rstate = FIRSTEOT;
-        serial->read();
-        goto back;
-      }
-      return 1;
-    } else if (rstate == SLIPESC) {
-      return 1;
-    } else if (rstate == FIRSTEOT) {
-      if (serial->peek() == eot) {
-        rstate = SECONDEOT;
-        serial->read();
-        return 0;
+        isEnd = true;
+        break;
       }
-      rstate = CHAR;
-    } else if (rstate == SECONDEOT) {
-      rstate = CHAR;
+      buffer[count++] = c;
     }
 
-    return 0;
+    return count;
   }
 
+  int available() {
+    return (inputEnd - inputStart) + serial->available();
+  }
+
+  // Read a single decoded byte, -1 at the end of a packet. Prefer
+  // `readPacket()`.
   int read() {
-  back:
-    uint8_t c = serial->read();
-    if (rstate == CHAR) {
-      if (c == slipEsc) {
-        rstate = SLIPESC;
-        goto back;
-      } else if (c == eot) {
-        return -1;
-      }
-      return c;
-    } else if (rstate == SLIPESC) {
-      rstate = CHAR;
-      if (c == slipEscEnd) {
-        return eot;
-      } else if (c == slipEscEsc) {
-        return slipEsc;
-      } else {
-        return -1;
-      }
-    } else {
-      return -1;
-    }
+    uint8_t c;
+    bool isEnd;
+    return readPacket(&c, 1, isEnd) ? c : -1;
   }
 
-  int readBytes(uint8_t *buffer, size_t size);
+  // Not supported, the input is decoded packet-wise.
+  int peek() { return -1; }
 
   size_t write(uint8_t b) {
-    if (b == eot) {
-      serial->write(slipEsc);
-      return serial->write(slipEscEnd);
-    } else if (b == slipEsc) {
-      serial->write(slipEsc);
-      return serial->write(slipEscEsc);
-    } else {
-      return serial->write(b);
-    }
+    putEscaped(b);
+    return 1;
   }
 
   size_t write(const uint8_t *buffer, size_t size) {
-    size_t result = 0;
-    while (size--) {
-      result = write(*buffer++);
-    }
-    return result;
+    for (size_t i = 0; i < size; i++) putEscaped(buffer[i]);
+    return size;
   }
 
-  int peek() {
-    uint8_t c = serial->peek();
-    if (rstate == SLIPESC) {
-      if (c == slipEscEnd) {
-        return eot;
-      } else if (c == slipEscEsc) {
-        return slipEsc;
-      }
-    }
-    return c;
-  }
+  void beginPacket() { put(eot); }
 
-  bool endOfPacket() {
-    if (rstate == SECONDEOT) {
-      rstate = CHAR;
-      return true;
-    }
+  void endPacket() {
+    put(eot);
+    if (coalesceInterval == 0) return flush();
 
-    if (rstate == FIRSTEOT) {
-      if (serial->available()) {
-        uint8_t c = serial->peek();
-        if (c == eot) {
-          serial->read();
-        }
-      }
-      rstate = CHAR;
-      return true;
+    if (!isPending) {
+      isPending = true;
+      pendingTime = micros();
     }
+  }
 
-    return false;
+  // Collect finished packets for up to `interval` (μs) before sending them,
+  // zero disables coalescing.
+  void setCoalesceInterval(uint32_t interval) {
+    coalesceInterval = interval;
+    if (interval == 0) flush();
   }
 
-  void beginPacket() { serial->write(eot); }
+  // Send the coalesced packets once they are due, should be called each loop.
+  void update() {
+    if (isPending && micros() - pendingTime >= coalesceInterval) flush();
+  }
 
-  void endPacket() {
-    serial->write(eot);
+  void flush() {
+    flushOutput();
     serial->send_now();
+    isPending = false;
   }
 
-  void flush() { serial->flush(); }
-
   operator bool() const { return *serial; }
 };
 
@@ -1,12 +1,19 @@
 import { watch } from 'chokidar'
 import { readFile } from 'node:fs/promises'
 import { resolve } from 'node:path'
+import { crc32 } from 'node:zlib'
 import { WebSocket, WebSocketServer } from 'ws'
 import mitt, { Emitter } from 'mitt'
 // @ts-ignore (missing types)
 import launch from 'launch-editor'
 
-type Message = { id: number; method: string; file?: string }
+type Message = {
+  id: number
+  method: string
+  file?: string
+  result?: unknown
+}
+type FileHash = { path: string; size: number; hash: number }
 type Events = { message: Message }
 
 const pathToPosix = (path: string) => path.replace(/\\/g, '/')
@@ -32,8 +39,10 @@ const setupConnection = (socket: WebSocket) => {
 
   emitter.on('message', async ({ method, file }: Message) => {
     if (method === 'deviceConnected') {
+      // Only transfer files that differ from the ones on the device.
+      const hashes = await getDeviceHashes()
       for (let path of filesToSync) {
-        await syncFile(path, false)
+        if (!(await isFileSynced(path, hashes))) await syncFile(path, false)
       }
       filesToSync = []
       return
@@ -59,12 +68,35 @@ const setupConnection = (socket: WebSocket) => {
     }
   }
 
+  const getDeviceHashes = async () => {
+    const hashes = new Map<string, FileHash>()
+    const id = requestId++
+    socket.send(JSON.stringify({ id, method: 'getHashes' }))
+    try {
+      const result = (await waitForResponse(id)) as FileHash[]
+      for (const hash of result) hashes.set(hash.path, hash)
+    } catch (e) {
+      // Without hashes every file is synced.
+      console.warn(e)
+    }
+    return hashes
+  }
+
+  const isFileSynced = async (path: string, hashes: Map<string, FileHash>) => {
+    const deviceHash = hashes.get(pathToPosix(path))
+    if (!deviceHash) return false
+    const content = await readFile(resolve('src', path))
+    return (
+      content.length === deviceHash.size && crc32(content) === deviceHash.hash
+    )
+  }
+
   const waitForResponse = (id: number) =>
-    new Promise<void>((resolve, reject) => {
+    new Promise<unknown>((resolve, reject) => {
       const handler = (data: Message) => {
         if (id === data.id) {
           emitter.off('message', handler)
-          resolve()
+          resolve(data.result)
         }
       }
       emitter.on('message', handler)
@@ -1,4 +1,11 @@
-Connections = {}
+Connections = {
+  ---Connections (from, to) that are forwarded natively by a midi route.
+  ---@type table<number, table<number, boolean>>
+  routed = {},
+}
+
+---@type number[]
+local routeIds = {}
 
 ---@param serialized ConnectionSerialized[]
 function Connections.deserialize(serialized)
@@ -8,6 +15,7 @@ function Connections.deserialize(serialized)
     if not item then error(Log.messageItemNotFound(fromId)) end
     item:__connect(fromIndex, toId, toIndex)
   end
+  Connections.updateRoutes()
 end
 
 ---@param fromId number
@@ -18,6 +26,7 @@ function Connections.add(fromId, outputIndex, toId, inputIndex)
   local fromItem = Items.instances[fromId]
   if not fromItem then error(Log.messageItemNotFound(fromId)) end
   fromItem:__connect(outputIndex, toId, inputIndex)
+  Connections.updateRoutes()
 end
 
 ---@param fromId number
@@ -28,4 +37,50 @@ function Connections.remove(fromId, outputIndex, toId, inputIndex)
   local fromItem = Items.instances[fromId]
   if not fromItem then error(Log.messageItemNotFound(fromId)) end
   fromItem:__disconnect(outputIndex, toId, inputIndex)
+  Connections.updateRoutes()
+end
+
+---@param fromId number
+---@param toId number
+function Connections.isRouted(fromId, toId)
+  local routed = Connections.routed[fromId]
+  return routed and routed[toId] or false
+end
+
+---Forward the messages of each `Input` connected directly to an `Output` with a
+---native midi route instead of passing them through lua. The input is still
+---passed to lua, so the `Input` keeps track of its active notes (to finish
+---them and to show them in the app), it just isn't output to the routed
+---connections (see `Item:__output()`). The routed notes that are still held
+---when a route is removed are released natively.
+function Connections.updateRoutes()
+  for _, id in ipairs(routeIds) do
+    Midi.removeRoute(id)
+  end
+  routeIds = {}
+  Connections.routed = {}
+
+  for fromId, item in pairs(Items.instances) do
+    if item.__type == 'Input' then
+      for _, connection in pairs(item.__outputs[1] or {}) do
+        local toId = connection[1]
+        local toItem = Items.instances[toId]
+        if toItem and toItem.__type == 'Output' then
+          local routeId = Midi.addRoute({
+            input = item.props.device,
+            inputCable = item.props.cable,
+            output = toItem.props.device,
+            -- See `Output:__output()`, which always uses the first cable.
+            outputCable = 1,
+            keepInput = true,
+          })
+          if routeId then
+            routeIds[#routeIds + 1] = routeId
+            Connections.routed[fromId] = Connections.routed[fromId] or {}
+            Connections.routed[fromId][toId] = true
+          end
+        end
+      end
+    end
+  end
 end
@@ -2,13 +2,23 @@
 
 -- https://github.com/miwos/firmware/blob/main/include/LuaDisplays.h
 ---@class Displays
----@field text fun(index: number, text: string, color: Color)
+---@field text fun(index: number, text: string, color: Color, x?: number, y?: number, width?: number) `y` is the baseline (default 17), text beyond `width` is clipped.
+---@field measureText fun(text: string): number
 ---@field drawPixel fun(index: number, x: number, y: number, color: Color)
 ---@field drawLine fun(index: number, x0: number, y0: number, x1: number, y1: number, color: Color)
 ---@field drawTriangle fun(index: number, x0: number, y0: number, x1: number, y1: number, x2: number, y2: number, color: Color, fill: boolean)
 ---@field drawRectangle fun(index: number, x: number, y: number, width: number, height: number, color: Color, fill: boolean)
 ---@field drawRoundedRectangle fun(index: number, x: number, y: number, width: number, height: number, radius: number, color: Color, fill: boolean)
 ---@field drawCircle fun(index: number, x: number, y: number, radius: number, color: Color, fill: boolean)
+---@field createBitmap fun(rows: string[]): number? Every character other than a space or a dot is a set pixel.
+---@field loadBitmap fun(fileName: string): number? Load a binary PBM (P4) image.
+---@field captureBitmap fun(index: number, x: number, y: number, width: number, height: number): number?
+---@field removeBitmap fun(id: number): boolean
+---@field clearBitmaps fun()
+---@field drawBitmap fun(index: number, id: number, x: number, y: number, color: Color, opaque?: boolean, sourceX?: number, sourceY?: number, width?: number, height?: number)
+---@field draw fun(index: number, commands: (number | string | boolean)[])
 ---@field update fun(index: number)
 ---@field clear fun(index: number)
+---@field setLoopBudget fun(budget: number) Time (in μs) the displays may take per loop.
+---@field getFps fun(): number
 Displays = {}
@@ -99,20 +99,28 @@ function Item:scheduleOutput(index, message, time, useTicks)
   self:output(index, message)
 end
 
-function Item:__output(index, message)
+---@param index number
+---@param message MidiMessage|nil
+---@param includeRouted? boolean Also pass the message to connections that are
+---routed natively, e.g. to finish their notes.
+function Item:__output(index, message, includeRouted)
   if self.__outputs[index] then
     for _, input in pairs(self.__outputs[index]) do
       local inputId, inputIndex = unpack(input)
       local item = Items.instances[inputId]
       if not item then error(Log.messageItemNotFound(inputId)) end
 
-      local name = message and Midi.TypeName[message.type] or 'trigger'
-      local numberedInput = 'input[' .. inputIndex .. ']'
-
-      item:callEvent('input', inputIndex, message)
-      item:callEvent('input:' .. name, inputIndex, message)
-      item:callEvent(numberedInput, message)
-      item:callEvent(numberedInput .. ':' .. name, message)
+      -- Routed connections are already forwarded natively, see
+      -- `Connections.updateRoutes()`.
+      if includeRouted or not Connections.isRouted(self.__id, inputId) then
+        local name = message and Midi.TypeName[message.type] or 'trigger'
+        local numberedInput = 'input[' .. inputIndex .. ']'
+
+        item:callEvent('input', inputIndex, message)
+        item:callEvent('input:' .. name, inputIndex, message)
+        item:callEvent(numberedInput, message)
+        item:callEvent(numberedInput .. ':' .. name, message)
+      end
     end
   end
 end
@@ -122,7 +130,7 @@ function Item:__finishNotes(output)
   for activeNote in pairs(self.__activeNotes) do
     local index, note, channel = Utils.unpackBytes(activeNote)
     if not output or index == output then
-      self:__output(index, Midi.NoteOff(note, 0, channel))
+      self:__output(index, Midi.NoteOff(note, 0, channel), true)
     end
   end
   self.__activeNotes = {}
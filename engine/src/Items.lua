@@ -95,6 +95,7 @@ function Items.remove(id)
   local item = Items.instances[id]
   Utils.callIfExists(item.__destroy, item)
   Items.instances[id] = nil
+  Connections.updateRoutes()
   -- TODO: unrequire the items Constructur if no other items are using it.
 end
 
@@ -3,13 +3,32 @@
 ---@field __start fun()
 ---@field __stop fun()
 ---@field getIsPlaying fun(): boolean
----@field setTempo fun(bpm: number)
+---@field setTempo fun(bpm: number, rampDuration?: number)
 ---@field getTempo fun(): number
+---@field setClockSource fun(index?: number)
+---@field getClockSource fun(): number | nil
+---@field addRoute fun(route: MidiRoute): number | nil
+---@field removeRoute fun(id: number): boolean
+---@field clearRoutes fun()
+---@field getInputOverflows fun(index: number): number
+---@field getClockStats fun(): { ticks: number, lastError: number, maxError: number, averageError: number }
 ---@field NoteOn fun(note, velocity, channel): MidiNoteOn
 ---@field NoteOff fun(note, velocity, channel): MidiNoteOff
 ---@field ControlChange fun(note, velocity, channel): MidiControlChange
 Midi = _G.Midi or {}
 
+---A static connection handled natively, without calling into lua. Omitted
+---cables and channels match (or keep) any cable or channel.
+---@class MidiRoute
+---@field input number
+---@field inputCable? number
+---@field inputChannel? number
+---@field output number
+---@field outputCable? number
+---@field outputChannel? number
+---@field transpose? number
+---@field keepInput? boolean Also pass the input on to `Midi.handleInput()`.
+
 Utils.mixin(Midi, require('EventEmitter'))
 Midi.__events = {}
 
@@ -48,6 +67,22 @@ function Midi.handleInput(index, type, data1, data2, channel, cable)
   Midi:emit('input', index, message, cable)
 end
 
+---Called once per update with all inputs received since the last call.
+---@param inputs number[] A flat list of each input's `index, type, data1, data2, channel, cable` (reused between calls).
+---@param count number
+function Midi.handleInputs(inputs, count)
+  for i = 1, count * 6, 6 do
+    Midi.handleInput(
+      inputs[i],
+      inputs[i + 1],
+      inputs[i + 2],
+      inputs[i + 3],
+      inputs[i + 4],
+      inputs[i + 5]
+    )
+  end
+end
+
 function Midi.handleClock(tick)
   -- Midi.send(1, Midi.NoteOn(62, 127, 1), 1)
 end
@@ -62,14 +97,24 @@ end
 
 function Midi.start()
   Midi.__start()
+  Midi.handleExternalStart()
+end
+
+function Midi.stop()
+  Midi.__stop()
+  Midi.handleExternalStop()
+end
+
+---Called when the clock source (see `Midi.setClockSource()`) starts.
+function Midi.handleExternalStart()
   for _, item in pairs(Items.instances) do
     item:callEvent('clock:start')
   end
 end
 
-function Midi.stop()
+---Called when the clock source (see `Midi.setClockSource()`) stops.
+function Midi.handleExternalStop()
   Timer.clearScheduledMidi()
-  Midi.__stop()
   for _, item in pairs(Items.instances) do
     item:callEvent('clock:stop')
     item:__finishNotes()
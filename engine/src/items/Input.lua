@@ -39,6 +39,11 @@ Input:event('prop:beforeChange', function(self)
   self:__finishNotes()
 end)
 
+Input:event('prop:change', function()
+  -- The device or cable of a native midi route might have changed.
+  Connections.updateRoutes()
+end)
+
 function Input:destroy()
   Midi:off('input', self.midiInputEventHandler)
 end
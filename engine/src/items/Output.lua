@@ -27,6 +27,11 @@ Output:event('prop:beforeChange', function(self)
   self:__finishNotes()
 end)
 
+Output:event('prop:change', function()
+  -- The device or cable of a native midi route might have changed.
+  Connections.updateRoutes()
+end)
+
 Output:event('input[1]', function(self, message)
   self:output(1, message)
 end)
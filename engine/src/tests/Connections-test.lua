@@ -0,0 +1,44 @@
+describe('Connections', function()
+  it('releases held notes when a routed output changes its device', function()
+    local addRoute, removeRoute = Midi.addRoute, Midi.removeRoute
+    local send = Midi.send
+
+    local routes, removedRoutes, sent = {}, {}, {}
+    Midi.addRoute = function(route)
+      routes[#routes + 1] = route
+      return #routes
+    end
+    Midi.removeRoute = function(id)
+      removedRoutes[#removedRoutes + 1] = id
+    end
+    Midi.send = function(device, message)
+      sent[#sent + 1] = { device, message }
+    end
+
+    Items.add(1, 'Input', { device = 2, cable = 1 })
+    Items.add(2, 'Output', { device = 3 })
+    Connections.add(1, 1, 2, 1)
+    expect(#routes):toBe(1)
+    expect(routes[1].output):toBe(3)
+
+    -- The note is forwarded natively, lua only keeps track of it.
+    Items.instances[1]:handleMidiInput(2, Midi.NoteOn(60, 100, 1), 1)
+    expect(#sent):toBe(0)
+
+    -- Removing the old route releases its held notes natively.
+    Items.updateProp(2, 'device', 4, false)
+    expect(removedRoutes[1]):toBe(1)
+    expect(routes[#routes].output):toBe(4)
+
+    -- Notes held by the input itself are finished on the current device.
+    Items.updateProp(1, 'device', 5, false)
+    expect(#sent):toBe(1)
+    expect(sent[1][1]):toBe(4)
+    expect(sent[1][2]:is(Midi.Type.NoteOff)):toBe(true)
+    expect(sent[1][2].note):toBe(60)
+
+    Items.clear()
+    Midi.addRoute, Midi.removeRoute = addRoute, removeRoute
+    Midi.send = send
+  end)
+end)
@@ -11,6 +11,20 @@ Display.Color = {
   White = 1,
 }
 
+---The commands of `Display:draw()`, keep in sync with `DisplaysLib::Command`.
+---@enum DisplayCommand
+Display.Command = {
+  Pixel = 1,
+  Line = 2,
+  Triangle = 3,
+  Rectangle = 4,
+  RoundedRectangle = 5,
+  Circle = 6,
+  Text = 7,
+  Clear = 8,
+  Bitmap = 9,
+}
+
 Display.width = 128
 Display.height = 32
 
@@ -20,8 +34,17 @@ end
 
 ---@param text string
 ---@param color Color
-function Display:text(text, color)
-  Displays.text(self.index, text, color)
+---@param x? number
+---@param y? number The baseline, defaults to 17.
+---@param width? number Clip the text beyond this width.
+function Display:text(text, color, x, y, width)
+  Displays.text(self.index, text, color, x, y, width)
+end
+
+---@param text string
+---@return number
+function Display:measureText(text)
+  return Displays.measureText(text)
 end
 
 ---@param x number
@@ -91,6 +114,63 @@ function Display:drawCircle(x, y, radius, color, fill)
   Displays.drawCircle(self.index, x, y, radius, color, fill)
 end
 
+---Blit a bitmap (see `Displays.createBitmap()` and friends). Only its set
+---pixels are drawn, unless it is `opaque`. Pass a source rectangle to only
+---draw a part of it, a `width` or `height` of zero means up to the edge.
+---@param id number
+---@param x number
+---@param y number
+---@param color Color
+---@param opaque? boolean
+---@param sourceX? number
+---@param sourceY? number
+---@param width? number
+---@param height? number
+function Display:drawBitmap(
+  id,
+  x,
+  y,
+  color,
+  opaque,
+  sourceX,
+  sourceY,
+  width,
+  height
+)
+  Displays.drawBitmap(
+    self.index,
+    id,
+    x,
+    y,
+    color,
+    opaque,
+    sourceX,
+    sourceY,
+    width,
+    height
+  )
+end
+
+---Copy a part of the display into a new bitmap.
+---@param x number
+---@param y number
+---@param width number
+---@param height number
+---@return number? id
+function Display:captureBitmap(x, y, width, height)
+  return Displays.captureBitmap(self.index, x, y, width, height)
+end
+
+---Draw a whole list of commands in one go, which is a lot faster than calling
+---the single draw functions. Each command is followed by the arguments of its
+---draw function, e.g.: `{ Display.Command.Pixel, x, y, color }`. Optional
+---arguments can't be omitted, e.g.: `{ Display.Command.Text, text, color, x,
+---y, width }`.
+---@param commands (number | string | boolean)[]
+function Display:draw(commands)
+  Displays.draw(self.index, commands)
+end
+
 function Display:clear()
   Displays.clear(self.index)
 end
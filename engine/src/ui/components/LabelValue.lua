@@ -36,22 +36,28 @@ function LabelValue:draw()
   local props = self.props
   local display = self.children.display --[[@as Display]]
 
-  -- Clear
-  display:drawRectangle(
+  local text = self.view == self.Views.Label and props.label
+    or option(props.before, '')
+      .. option(props.value, 0)
+      .. option(props.after, '')
+
+  display:draw({
+    -- Clear
+    Display.Command.Rectangle,
     props.x,
     props.y,
     props.width,
     props.height,
     Display.Color.Black,
-    true
-  )
-
-  -- Show value or label
-  local text = self.view == self.Views.Label and props.label
-    or option(props.before, '')
-      .. option(props.value, 0)
-      .. option(props.after, '')
-  display:text(text, Display.Color.White)
+    true,
+    -- Show value or label
+    Display.Command.Text,
+    text,
+    Display.Color.White,
+    props.x,
+    props.y + 17,
+    props.width,
+  })
 
   display:update()
 end
@@ -18,67 +18,144 @@ function ProgressBar:render()
 end
 
 function ProgressBar:mount()
+  self:createBitmaps()
   self:draw()
 end
 
-function ProgressBar:draw()
+---Render the empty and the full bar once, so a redraw only has to blit (a
+---part of) each of them instead of drawing all the shapes again. The bars are
+---rendered on the display, which is restored afterwards. As this happens
+---before the display is updated again, none of it is ever shown.
+function ProgressBar:createBitmaps()
   local props = self.props
   local display = self.children.display --[=[@as Display]=]
+  local Command, Color = Display.Command, Display.Color
+  local x, y, width, height = props.x, props.y, props.width, props.height
+
+  -- Save the whole display, the scale can reach beyond the bar.
+  local saved = display:captureBitmap(0, 0, Display.width, Display.height)
+
+  -- The rounded bar doesn't cover the corners of the captured area.
+  local clear = { Command.Rectangle, x, y, width, height, Color.Black, true }
+
+  display:draw(clear)
+  display:draw(self:getCommands(0))
+  self.emptyBitmap = display:captureBitmap(x, y, width, height)
+
+  display:draw(clear)
+  display:draw(self:getCommands(1))
+  self.fullBitmap = display:captureBitmap(x, y, width, height)
+
+  if saved then
+    display:drawBitmap(saved, 0, 0, Color.White, true)
+    Displays.removeBitmap(saved)
+  end
+end
 
-  -- Clear
-  display:drawRoundedRectangle(
+---@param value number
+function ProgressBar:getCommands(value)
+  local props = self.props
+  local Command, Color = Display.Command, Display.Color
+  local radius = props.height / 2
+  local barWidth = math.floor(value * props.width)
+  local commands = {
+    -- Clear
+    Command.RoundedRectangle,
     props.x,
     props.y,
     props.width,
     props.height,
-    props.height / 2,
-    Display.Color.Black,
-    true
-  )
-
-  -- Draw the complete filled bar.
-  display:drawRoundedRectangle(
+    radius,
+    Color.Black,
+    true,
+    -- Draw the complete filled bar.
+    Command.RoundedRectangle,
     props.x,
     props.y,
     props.width,
     props.height,
-    props.height / 2,
-    Display.Color.White,
-    true
-  )
-
-  -- Crop the filled bar to match the value.
-  local barWidth = math.floor(props.value * props.width)
-  display:drawRectangle(
+    radius,
+    Color.White,
+    true,
+    -- Crop the filled bar to match the value.
+    Command.Rectangle,
     props.x + barWidth,
     props.y,
     props.width - barWidth,
     props.height,
-    Display.Color.Black,
-    true
-  )
-
-  -- Add the outline
-  display:drawRoundedRectangle(
+    Color.Black,
+    true,
+    -- Add the outline
+    Command.RoundedRectangle,
     props.x,
     props.y,
     props.width,
     props.height,
-    self.props.height / 2,
-    Display.Color.White,
-    false
-  )
+    radius,
+    Color.White,
+    false,
+  }
 
   -- Optionally, add a scale
   if props.showScale ~= nil then
     -- Omit the first and last scale markers.
     for x = props.scaleStep, props.width, props.scaleStep do
-      local color = x < (props.x + barWidth - 1) and Display.Color.Black
-        or Display.Color.White
-      display:drawLine(x, props.y + 1, x, Display.height - 1, color)
+      local color = x < (props.x + barWidth - 1) and Color.Black or Color.White
+      local length = #commands
+      commands[length + 1] = Command.Line
+      commands[length + 2] = x
+      commands[length + 3] = props.y + 1
+      commands[length + 4] = x
+      commands[length + 5] = Display.height - 1
+      commands[length + 6] = color
     end
   end
 
+  return commands
+end
+
+function ProgressBar:draw()
+  local props = self.props
+  local display = self.children.display --[=[@as Display]=]
+
+  -- Fall back to the shapes if there was no room for the bitmaps.
+  if not (self.emptyBitmap and self.fullBitmap) then
+    display:draw(self:getCommands(props.value))
+    display:update()
+    return
+  end
+
+  local Command, Color = Display.Command, Display.Color
+  local barWidth = math.floor(props.value * props.width)
+  local commands = {
+    -- The empty bar, with the full one's left part on top of it.
+    Command.Bitmap,
+    self.emptyBitmap,
+    props.x,
+    props.y,
+    Color.White,
+    true,
+    0,
+    0,
+    0,
+    0,
+  }
+
+  if barWidth > 0 then
+    local length = #commands
+    commands[length + 1] = Command.Bitmap
+    commands[length + 2] = self.fullBitmap
+    commands[length + 3] = props.x
+    commands[length + 4] = props.y
+    commands[length + 5] = Color.White
+    commands[length + 6] = true
+    commands[length + 7] = 0
+    commands[length + 8] = 0
+    commands[length + 9] = barWidth
+    commands[length + 10] = 0
+  end
+
+  display:draw(commands)
   display:update()
 end
 
@@ -86,4 +163,9 @@ ProgressBar:event('prop[value]:change', function(self)
   self:draw()
 end)
 
+function ProgressBar:unmount()
+  if self.emptyBitmap then Displays.removeBitmap(self.emptyBitmap) end
+  if self.fullBitmap then Displays.removeBitmap(self.fullBitmap) end
+end
+
 return ProgressBar
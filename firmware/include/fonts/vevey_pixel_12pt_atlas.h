@@ -0,0 +1,271 @@
+// Generated from `vevey_pixel_12pt.h` by `scripts/font_atlas.py`.
+
+#ifndef vevey_pixel_12pt_atlas_h
+#define vevey_pixel_12pt_atlas_h
+
+#include <FontAtlas.h>
+
+const uint32_t vevey_pixel_12ptAtlasColumns[] PROGMEM = {
+  0x00038000, 0x00039ffe, 0x00039ffe, 0x0000007e, 0x0000007e, 0x00000000,
+  0x00000000, 0x0000007e, 0x0000007e, 0x00003000, 0x00033000, 0x0003f060,
+  0x0001fc60, 0x00003fe0, 0x000033f8, 0x0003307e, 0x0003f066, 0x0000fe60,
+  0x00003fe0, 0x000031f8, 0x0000307e, 0x00000066, 0x00000060, 0x00000038,
+  0x000000fe, 0x000000c6, 0x00000183, 0x00000183, 0x00000183, 0x000380c6,
+  0x0003e07e, 0x0000f838, 0x00003e00, 0x00000f80, 0x000003e0, 0x0000e0f8,
+  0x0003f03e, 0x0003180e, 0x00060c00, 0x00060c00, 0x00060c00, 0x00031800,
+  0x0003f800, 0x0000e000, 0x0000f000, 0x0001fc78, 0x00038efc, 0x000307ce,
+  0x00030386, 0x00030706, 0x00030f86, 0x00039dce, 0x0001b8fc, 0x0000f078,
+  0x0000fc00, 0x0001dc00, 0x00038000, 0x00030000, 0x0000007e, 0x0000007e,
+  0x00007fc0, 0x0001fff0, 0x0007c07c, 0x000e000e, 0x000c0006, 0x000c0006,
+  0x000e000e, 0x0007c07c, 0x0001fff0, 0x00007f80, 0x00000630, 0x00000770,
+  0x000003e0, 0x000001fc, 0x000000fc, 0x000001f0, 0x000003e0, 0x00000770,
+  0x00000630, 0x00000600, 0x00000600, 0x00000600, 0x00000600, 0x00007fe0,
+  0x00007fe0, 0x00000600, 0x00000600, 0x00000600, 0x00000600, 0x000e0000,
+  0x000fc000, 0x0003e000, 0x0000e000, 0x00000c00, 0x00000c00, 0x00000c00,
+  0x00000c00, 0x00000c00, 0x00000c00, 0x00000c00, 0x00000c00, 0x00000c00,
+  0x00038000, 0x00038000, 0x00038000, 0x00038000, 0x0003e000, 0x0000f800,
+  0x00003e00, 0x00000f80, 0x000003e0, 0x000000f8, 0x0000003e, 0x0000000e,
+  0x00003fe0, 0x0000fff8, 0x0001e03c, 0x0001800c, 0x00030006, 0x00030006,
+  0x00030006, 0x00030006, 0x0001800c, 0x0001e03c, 0x0000fff8, 0x00001fc0,
+  0x000000c0, 0x000000c0, 0x000000c0, 0x000000e0, 0x00000078, 0x0003fffc,
+  0x0003fffc, 0x0003e0f0, 0x0003f0fc, 0x0003381c, 0x00031c06, 0x00030c06,
+  0x00030e06, 0x00030606, 0x0003070e, 0x0003038c, 0x000301fc, 0x000300f0,
+  0x0000c030, 0x0001c03c, 0x0001800c, 0x00030006, 0x00030306, 0x00030306,
+  0x00030306, 0x0003078c, 0x000186fc, 0x0001fc70, 0x00007800, 0x00001c00,
+  0x00003e00, 0x00003780, 0x000031fc, 0x0000307c, 0x00003000, 0x00003000,
+  0x00003000, 0x0003ffe0, 0x0003ffe0, 0x00003000, 0x00003000, 0x00003000,
+  0x0000c000, 0x0001c7f8, 0x000187fc, 0x0003030c, 0x0003018c, 0x0003018c,
+  0x0003018c, 0x0003818c, 0x0001c30c, 0x0000ff0c, 0x00007c00, 0x00003fc0,
+  0x0000fff0, 0x0001e338, 0x0001818c, 0x000300c6, 0x000300c6, 0x000300c6,
+  0x000300c6, 0x000381c6, 0x0001c38c, 0x0000ff1c, 0x00007e18, 0x0000000c,
+  0x0000000c, 0x0003c00c, 0x0003f80c, 0x00007e0c, 0x00000f8c, 0x000003cc,
+  0x000000ec, 0x0000007c, 0x0000003c, 0x00000018, 0x00007800, 0x0001fc70,
+  0x000186fc, 0x0003038c, 0x00030306, 0x00030306, 0x00030306, 0x00030306,
+  0x0001878c, 0x0001fcfc, 0x00007870, 0x0000c3f0, 0x0001c7f8, 0x00018e1c,
+  0x00031c0e, 0x00031806, 0x00031806, 0x00031806, 0x00031806, 0x00018c0c,
+  0x0001e63c, 0x00007ff8, 0x00001fe0, 0x000380e0, 0x000380e0, 0x000380e0,
+  0x000e0000, 0x000fc000, 0x0003e0e0, 0x0000e0e0, 0x000000e0, 0x00003180,
+  0x00003180, 0x00003180, 0x00003180, 0x00003180, 0x00003180, 0x00003180,
+  0x00003180, 0x00003180, 0x00003180, 0x000000f0, 0x000000fc, 0x0000000c,
+  0x00038006, 0x00039c06, 0x00039e06, 0x00000606, 0x00000306, 0x0000038c,
+  0x000001fc, 0x000000f0, 0x00038000, 0x0003e000, 0x0000f800, 0x00003f00,
+  0x000037c0, 0x000031f0, 0x0000307c, 0x0000300e, 0x0000301e, 0x0000307c,
+  0x000031f0, 0x000037c0, 0x00003e00, 0x0000f800, 0x0003e000, 0x00038000,
+  0x0001fffc, 0x0003fffe, 0x00030306, 0x00030306, 0x00030306, 0x00030306,
+  0x00030306, 0x00030306, 0x00030306, 0x0003078e, 0x00018efc, 0x0001fc78,
+  0x00007800, 0x00001fc0, 0x00007ff0, 0x0000e078, 0x0001c01c, 0x0001800c,
+  0x0003000e, 0x00030006, 0x00030006, 0x00030006, 0x00030006, 0x0003800e,
+  0x0001800c, 0x0001c01c, 0x0000c018, 0x0001fffc, 0x0003fffe, 0x00030006,
+  0x00030006, 0x00030006, 0x00030006, 0x00030006, 0x00030006, 0x00030006,
+  0x0001800c, 0x0001c01c, 0x0000e038, 0x00007ff0, 0x00001fc0, 0x0001fffc,
+  0x0003fffe, 0x00030306, 0x00030306, 0x00030306, 0x00030306, 0x00030306,
+  0x00030306, 0x00030306, 0x00030306, 0x00030306, 0x00030006, 0x0003fffc,
+  0x0003fffe, 0x00000306, 0x00000306, 0x00000306, 0x00000306, 0x00000306,
+  0x00000306, 0x00000306, 0x00000306, 0x00000306, 0x00000006, 0x00001fc0,
+  0x00007ff0, 0x0000f078, 0x0001c01c, 0x0001800c, 0x0003800e, 0x00030306,
+  0x00030306, 0x00030306, 0x00030306, 0x00030306, 0x0001830e, 0x0001831c,
+  0x0000ff18, 0x00007e00, 0x0003fffe, 0x0003fffe, 0x00000300, 0x00000300,
+  0x00000300, 0x00000300, 0x00000300, 0x00000300, 0x00000300, 0x00000300,
+  0x00000300, 0x00000300, 0x0003fffe, 0x0003fffe, 0x0003fffe, 0x0003fffe,
+  0x0000c000, 0x0001c000, 0x00018000, 0x00038000, 0x00030000, 0x00030000,
+  0x00030000, 0x00030000, 0x0001c000, 0x0001fffe, 0x00007ffe, 0x0003fffe,
+  0x0003fffe, 0x000001c0, 0x00000380, 0x00000780, 0x00000fc0, 0x00001ce0,
+  0x00003870, 0x00007038, 0x0000e01c, 0x0001c00e, 0x00038006, 0x00030000,
+  0x0001fffe, 0x0003fffe, 0x00030000, 0x00030000, 0x00030000, 0x00030000,
+  0x00030000, 0x00030000, 0x00030000, 0x00030000, 0x00030000, 0x0003fffc,
+  0x0003fffe, 0x0000001e, 0x0000007c, 0x000001f0, 0x00000fc0, 0x00003f00,
+  0x0000f800, 0x0003e000, 0x00038000, 0x0003e000, 0x0000f800, 0x00003e00,
+  0x00000f80, 0x000003f0, 0x000000fc, 0x0000001e, 0x0003fffe, 0x0003fffc,
+  0x0003fffc, 0x0003fffe, 0x0000000e, 0x0000003e, 0x000000f8, 0x000003e0,
+  0x00000f80, 0x00003e00, 0x0000f800, 0x0001e000, 0x00038000, 0x0003fffe,
+  0x0001fffe, 0x00001fc0, 0x00007ff0, 0x0000e038, 0x0001c01c, 0x0001800c,
+  0x00030006, 0x00030006, 0x00030006, 0x00030006, 0x00030006, 0x00030006,
+  0x0001800c, 0x0001c01c, 0x0000e038, 0x00007ff0, 0x00001fc0, 0x0003fffc,
+  0x0003fffe, 0x00000606, 0x00000606, 0x00000606, 0x00000606, 0x00000606,
+  0x00000606, 0x00000606, 0x00000606, 0x0000030c, 0x000003fc, 0x000000f0,
+  0x00001fc0, 0x00007ff0, 0x0000e038, 0x0001c01c, 0x0001800c, 0x00030006,
+  0x00030006, 0x00030006, 0x00030006, 0x00030006, 0x00036006, 0x0001e00c,
+  0x0001c01c, 0x0003e038, 0x00037ff0, 0x00001fc0, 0x0003fffc, 0x0003fffe,
+  0x00000606, 0x00000606, 0x00000606, 0x00000e06, 0x00001e06, 0x00003e06,
+  0x00007606, 0x0000e606, 0x0001c70c, 0x000383fc, 0x000300f0, 0x0000c070,
+  0x0001c0fc, 0x000181cc, 0x00038186, 0x00030386, 0x00030306, 0x00030706,
+  0x00030706, 0x0003060e, 0x00018e0c, 0x0001fc1c, 0x00007818, 0x00000006,
+  0x00000006, 0x00000006, 0x00000006, 0x00000006, 0x00000006, 0x00000006,
+  0x0003fffe, 0x0003fffe, 0x00000006, 0x00000006, 0x00000006, 0x00000006,
+  0x00000006, 0x00000006, 0x00003ffe, 0x0000fffe, 0x0001c000, 0x00018000,
+  0x00038000, 0x00030000, 0x00030000, 0x00030000, 0x00030000, 0x00038000,
+  0x00018000, 0x0001e000, 0x0000fffe, 0x00003ffe, 0x0000000e, 0x0000003e,
+  0x000000f8, 0x000003e0, 0x00001f80, 0x00007e00, 0x0001f000, 0x00038000,
+  0x0003c000, 0x0001f000, 0x00007c00, 0x00001f80, 0x000003e0, 0x000000f8,
+  0x0000003e, 0x0000000e, 0x0000000e, 0x0000007e, 0x000003f8, 0x00001fc0,
+  0x0000fe00, 0x0003f000, 0x00038000, 0x0001f800, 0x00007f80, 0x000007f0,
+  0x0000007c, 0x0000001c, 0x00000078, 0x000007e0, 0x00007f80, 0x0001fc00,
+  0x00038000, 0x0003f000, 0x0001fe00, 0x00001fc0, 0x000003f8, 0x0000007e,
+  0x0000000e, 0x00030000, 0x0003800c, 0x0001c01c, 0x0000e038, 0x00007070,
+  0x000038e0, 0x00001dc0, 0x00000f80, 0x00000700, 0x00000f80, 0x00001dc0,
+  0x000038e0, 0x00007070, 0x0000e038, 0x0001c01c, 0x0003800c, 0x00030000,
+  0x00000006, 0x0000000e, 0x0000001c, 0x00000038, 0x00000070, 0x000000e0,
+  0x000001c0, 0x0003ff80, 0x0003ffc0, 0x000000e0, 0x00000070, 0x00000038,
+  0x0000001c, 0x0000000e, 0x00000006, 0x0001c006, 0x0003e006, 0x00037006,
+  0x00033806, 0x00031c06, 0x00030e06, 0x00030706, 0x00030386, 0x000301c6,
+  0x000300e6, 0x00030076, 0x0003003e, 0x0003001c, 0x0000000e, 0x0000003e,
+  0x000000f8, 0x000003e0, 0x00000f80, 0x00003e00, 0x0000f800, 0x0003e000,
+  0x00038000, 0x000c0000, 0x000c0000, 0x000c0000, 0x000c0000, 0x000c0000,
+  0x000c0000, 0x000c0000, 0x000c0000, 0x000c0000, 0x00000003, 0x00000007,
+  0x0000000e, 0x00007f00, 0x0000ff80, 0x0001c1c0, 0x000380e0, 0x00030060,
+  0x00030060, 0x00030060, 0x00030060, 0x000180c0, 0x0000c180, 0x0003ffe0,
+  0x0003ffe0, 0x0003fffe, 0x0003fffe, 0x0000c180, 0x000180c0, 0x00030060,
+  0x00030060, 0x00030060, 0x00030060, 0x000380e0, 0x0001c1c0, 0x0000ff80,
+  0x00003e00, 0x00003e00, 0x0000ff80, 0x0001c1c0, 0x000380e0, 0x00030060,
+  0x00030060, 0x00030060, 0x00030060, 0x000380e0, 0x0001c1c0, 0x0000c180,
+  0x00003e00, 0x0000ff80, 0x0001c1c0, 0x000380e0, 0x00030060, 0x00030060,
+  0x00030060, 0x00030060, 0x000180c0, 0x0000c180, 0x0003fffe, 0x0003fffe,
+  0x00003f00, 0x0000ff80, 0x0001cdc0, 0x00018cc0, 0x00030c60, 0x00030c60,
+  0x00030c60, 0x00030c60, 0x00030ce0, 0x00018cc0, 0x00018f80, 0x00000700,
+  0x00000060, 0x00000060, 0x00000060, 0x0003fffc, 0x0003fffe, 0x00000066,
+  0x00000066, 0x00000066, 0x00000066, 0x00000060, 0x00000f00, 0x00033fc0,
+  0x000730c0, 0x000e6060, 0x000c6060, 0x000c6060, 0x000c6060, 0x000c6060,
+  0x000e30c0, 0x00061980, 0x0007ffe0, 0x0001ffe0, 0x0003fffe, 0x0003fffe,
+  0x00000180, 0x000000c0, 0x00000060, 0x00000060, 0x00000060, 0x00000060,
+  0x00000060, 0x000000c0, 0x0003ffc0, 0x0003ff00, 0x0003ffce, 0x0003ffce,
+  0x0000000e, 0x000fffce, 0x000fffce, 0x0000000e, 0x0003fffe, 0x0003fffe,
+  0x00003800, 0x00001c00, 0x00001e00, 0x00003f00, 0x00007380, 0x0000e1c0,
+  0x0001c0e0, 0x00038060, 0x00030000, 0x0003fffe, 0x0003fffe, 0x0003ffe0,
+  0x0003ffe0, 0x00000180, 0x000000c0, 0x00000060, 0x00000060, 0x00000060,
+  0x00000060, 0x000000e0, 0x0003ffc0, 0x0003ff80, 0x000001c0, 0x000000c0,
+  0x00000060, 0x00000060, 0x00000060, 0x00000060, 0x000000e0, 0x0003ffc0,
+  0x0003ff00, 0x0003ffe0, 0x0003ffe0, 0x00000180, 0x000000c0, 0x00000060,
+  0x00000060, 0x00000060, 0x00000060, 0x000000e0, 0x000001c0, 0x0003ffc0,
+  0x0003ff00, 0x00003e00, 0x0000ff80, 0x0001c1c0, 0x000180c0, 0x00030060,
+  0x00030060, 0x00030060, 0x00030060, 0x00030060, 0x000180c0, 0x0001c1c0,
+  0x0000ff80, 0x00003e00, 0x000fffe0, 0x000fffe0, 0x00006180, 0x0000c0c0,
+  0x00018060, 0x00018060, 0x00018060, 0x00018060, 0x0001c0e0, 0x0000e1c0,
+  0x00007f80, 0x00003f00, 0x00003f00, 0x00007f80, 0x0000e1c0, 0x0001c0e0,
+  0x00018060, 0x00018060, 0x00018060, 0x00018060, 0x0000c0c0, 0x00006180,
+  0x000fffe0, 0x000fffe0, 0x0003ffe0, 0x0003ffe0, 0x00000180, 0x000000c0,
+  0x00000060, 0x00000060, 0x00000060, 0x00000060, 0x0000c380, 0x0001c7c0,
+  0x00038ee0, 0x00030c60, 0x00030c60, 0x00031c60, 0x00031860, 0x0003b8e0,
+  0x0001f0c0, 0x0000e000, 0x00000060, 0x00000060, 0x00000060, 0x0000fffc,
+  0x0001fffc, 0x00038060, 0x00030060, 0x00030060, 0x00030060, 0x00007fe0,
+  0x0001ffe0, 0x0001c000, 0x00038000, 0x00030000, 0x00030000, 0x00030000,
+  0x00030000, 0x00018000, 0x0000c000, 0x0003ffe0, 0x0003ffe0, 0x000000e0,
+  0x000003e0, 0x00001f80, 0x00007e00, 0x0001f000, 0x00038000, 0x0003c000,
+  0x0001f800, 0x00007e00, 0x00000f80, 0x000003e0, 0x000000e0, 0x000000e0,
+  0x000007e0, 0x00007f80, 0x0001fc00, 0x00038000, 0x0003c000, 0x0001f800,
+  0x00003f80, 0x000007e0, 0x000000e0, 0x00000fe0, 0x00003f80, 0x0001f800,
+  0x0003c000, 0x00038000, 0x0001fc00, 0x00007f80, 0x000007e0, 0x000000e0,
+  0x00030060, 0x000380e0, 0x0001c1c0, 0x0000e380, 0x00007700, 0x00003e00,
+  0x00003e00, 0x00007700, 0x0000e380, 0x0001c1c0, 0x000380e0, 0x00030060,
+  0x000000e0, 0x000c01e0, 0x000c07c0, 0x000e1f00, 0x00073c00, 0x0003f000,
+  0x0001f000, 0x00007c00, 0x00001f00, 0x000007c0, 0x000001e0, 0x00000060,
+  0x00018060, 0x0003c060, 0x0003e060, 0x00037060, 0x00033860, 0x00031c60,
+  0x00030e60, 0x00030760, 0x000303e0, 0x000301c0, 0x0000c0c0, 0x0000c0c0,
+  0x0000c0c0, 0x0000c0c0, 0x0000cffc, 0x0000cffc, 0x0000c0c0, 0x0000c0c0,
+  0x0000c0c0, 0x0000c0c0,
+};
+
+const FontAtlas::Glyph vevey_pixel_12ptAtlasGlyphs[] PROGMEM = {
+  {    0,   0,   7,   0}, // 0x20 ' '
+  {    0,   3,   7,   2}, // 0x21 '!'
+  {    3,   6,  10,   2}, // 0x22 '"'
+  {    9,  14,  16,   1}, // 0x23 '#'
+  {   23,   0,   0,   0}, // 0x24 '$'
+  {   23,  21,  23,   1}, // 0x25 '%'
+  {   44,  14,  16,   1}, // 0x26 '&'
+  {   58,   2,   6,   2}, // 0x27 "'"
+  {   60,   5,   7,   1}, // 0x28 '('
+  {   65,   5,   7,   1}, // 0x29 ')'
+  {   70,   9,  13,   2}, // 0x2a '*'
+  {   79,  10,  14,   2}, // 0x2b '+'
+  {   89,   4,   7,   1}, // 0x2c ','
+  {   93,   9,  13,   2}, // 0x2d '-'
+  {  102,   3,   5,   1}, // 0x2e '.'
+  {  105,   9,  15,   1}, // 0x2f '/'
+  {  114,  12,  15,   1}, // 0x30 '0'
+  {  126,   7,  15,   3}, // 0x31 '1'
+  {  133,  11,  15,   2}, // 0x32 '2'
+  {  144,  11,  15,   2}, // 0x33 '3'
+  {  155,  13,  15,   1}, // 0x34 '4'
+  {  168,  11,  15,   2}, // 0x35 '5'
+  {  179,  12,  15,   1}, // 0x36 '6'
+  {  191,  11,  15,   2}, // 0x37 '7'
+  {  202,  11,  15,   2}, // 0x38 '8'
+  {  213,  12,  15,   1}, // 0x39 '9'
+  {  225,   3,   7,   2}, // 0x3a ':'
+  {  228,   5,   7,   1}, // 0x3b ';'
+  {  233,   0,   0,   0}, // 0x3c '<'
+  {  233,  10,  12,   1}, // 0x3d '='
+  {  243,   0,   0,   0}, // 0x3e '>'
+  {  243,  11,  13,   1}, // 0x3f '?'
+  {  254,   0,   0,   0}, // 0x40 '@'
+  {  254,  16,  18,   1}, // 0x41 'A'
+  {  270,  13,  16,   2}, // 0x42 'B'
+  {  283,  14,  16,   1}, // 0x43 'C'
+  {  297,  14,  17,   2}, // 0x44 'D'
+  {  311,  12,  16,   2}, // 0x45 'E'
+  {  323,  12,  16,   2}, // 0x46 'F'
+  {  335,  15,  17,   1}, // 0x47 'G'
+  {  350,  14,  18,   2}, // 0x48 'H'
+  {  364,   2,   6,   2}, // 0x49 'I'
+  {  366,  11,  14,   1}, // 0x4a 'J'
+  {  377,  13,  16,   2}, // 0x4b 'K'
+  {  390,  11,  15,   2}, // 0x4c 'L'
+  {  401,  19,  23,   2}, // 0x4d 'M'
+  {  420,  13,  17,   2}, // 0x4e 'N'
+  {  433,  16,  18,   1}, // 0x4f 'O'
+  {  449,  13,  16,   2}, // 0x50 'P'
+  {  462,  16,  19,   1}, // 0x51 'Q'
+  {  478,  13,  17,   2}, // 0x52 'R'
+  {  491,  12,  15,   2}, // 0x53 'S'
+  {  503,  15,  17,   1}, // 0x54 'T'
+  {  518,  14,  18,   2}, // 0x55 'U'
+  {  532,  16,  18,   1}, // 0x56 'V'
+  {  548,  23,  25,   1}, // 0x57 'W'
+  {  571,  17,  19,   1}, // 0x58 'X'
+  {  588,  15,  17,   1}, // 0x59 'Y'
+  {  603,  13,  15,   1}, // 0x5a 'Z'
+  {  616,   0,   0,   0}, // 0x5b '['
+  {  616,   9,  13,   2}, // 0x5c '\\'
+  {  625,   0,   0,   0}, // 0x5d ']'
+  {  625,   0,   0,   0}, // 0x5e '^'
+  {  625,   9,  13,   2}, // 0x5f '_'
+  {  634,   3,   6,   1}, // 0x60 '`'
+  {  637,  12,  15,   1}, // 0x61 'a'
+  {  649,  12,  15,   2}, // 0x62 'b'
+  {  661,  11,  13,   1}, // 0x63 'c'
+  {  672,  12,  15,   1}, // 0x64 'd'
+  {  684,  12,  14,   1}, // 0x65 'e'
+  {  696,  10,  12,   1}, // 0x66 'f'
+  {  706,  12,  15,   1}, // 0x67 'g'
+  {  718,  12,  16,   2}, // 0x68 'h'
+  {  730,   3,   7,   2}, // 0x69 'i'
+  {  733,   3,   7,   2}, // 0x6a 'j'
+  {  736,  11,  14,   2}, // 0x6b 'k'
+  {  747,   2,   6,   2}, // 0x6c 'l'
+  {  749,  20,  24,   2}, // 0x6d 'm'
+  {  769,  12,  16,   2}, // 0x6e 'n'
+  {  781,  13,  15,   1}, // 0x6f 'o'
+  {  794,  12,  15,   2}, // 0x70 'p'
+  {  806,  12,  15,   1}, // 0x71 'q'
+  {  818,   8,  11,   2}, // 0x72 'r'
+  {  826,  10,  12,   1}, // 0x73 's'
+  {  836,   9,  12,   1}, // 0x74 't'
+  {  845,  12,  16,   2}, // 0x75 'u'
+  {  857,  12,  14,   1}, // 0x76 'v'
+  {  869,  19,  21,   1}, // 0x77 'w'
+  {  888,  12,  14,   1}, // 0x78 'x'
+  {  900,  12,  14,   1}, // 0x79 'y'
+  {  912,  10,  12,   1}, // 0x7a 'z'
+  {  922,   0,   0,   0}, // 0x7b '{'
+  {  922,   0,   0,   0}, // 0x7c '|'
+  {  922,   0,   0,   0}, // 0x7d '}'
+  {  922,  10,  12,   1}, // 0x7e '~'
+};
+
+const FontAtlas::Font vevey_pixel_12pt_atlas PROGMEM = {
+  vevey_pixel_12ptAtlasColumns,
+  vevey_pixel_12ptAtlasGlyphs,
+  32, 126, -17, 20
+};
+
+#endif
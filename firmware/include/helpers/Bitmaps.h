@@ -0,0 +1,82 @@
+#ifndef Bitmaps_h
+#define Bitmaps_h
+
+#include <Arduino.h>
+#include <Display.h>
+
+/**
+ * A pool for the bitmaps (icons, pre-rendered widgets, ...) that are
+ * registered once and then blitted to the displays. All bitmap data is packed
+ * into one static buffer, removing a bitmap moves the data behind it down so
+ * the pool never fragments. Ids are one-based slot indexes.
+ */
+namespace Bitmaps {
+  const byte maxBitmaps = 64;
+  const uint16_t poolSize = 8192;
+  // Taller bitmaps wouldn't fit on a display anyway (see `Display::blit()`).
+  const uint8_t maxHeight = 32;
+
+  namespace {
+    Bitmap bitmaps[maxBitmaps];
+    uint8_t pool[poolSize];
+    uint16_t poolUsed = 0;
+
+    uint16_t getSize(uint8_t width, uint8_t height) {
+      return width * ((height + 7) / 8);
+    }
+  } // namespace
+
+  // Returns the new (empty) bitmap's id or zero if there is no room left.
+  byte add(uint8_t width, uint8_t height) {
+    if (width == 0 || height == 0 || height > maxHeight) return 0;
+
+    uint16_t size = getSize(width, height);
+    if (poolUsed + size > poolSize) return 0;
+
+    for (byte i = 0; i < maxBitmaps; i++) {
+      Bitmap &bitmap = bitmaps[i];
+      if (bitmap.data != NULL) continue;
+
+      bitmap.data = pool + poolUsed;
+      bitmap.width = width;
+      bitmap.height = height;
+      memset(bitmap.data, 0, size);
+      poolUsed += size;
+      return i + 1;
+    }
+    return 0;
+  }
+
+  Bitmap *get(byte id) {
+    if (id == 0 || id > maxBitmaps) return NULL;
+    Bitmap *bitmap = &bitmaps[id - 1];
+    return bitmap->data != NULL ? bitmap : NULL;
+  }
+
+  bool remove(byte id) {
+    Bitmap *removed = get(id);
+    if (removed == NULL) return false;
+
+    uint16_t size = getSize(removed->width, removed->height);
+    uint8_t *end = removed->data + size;
+    memmove(removed->data, end, pool + poolUsed - end);
+    poolUsed -= size;
+
+    for (byte i = 0; i < maxBitmaps; i++) {
+      if (bitmaps[i].data >= end) bitmaps[i].data -= size;
+    }
+    removed->data = NULL;
+    return true;
+  }
+
+  void clear() {
+    for (byte i = 0; i < maxBitmaps; i++) bitmaps[i].data = NULL;
+    poolUsed = 0;
+  }
+
+  uint16_t getFreeMemory() {
+    return poolSize - poolUsed;
+  }
+} // namespace Bitmaps
+
+#endif
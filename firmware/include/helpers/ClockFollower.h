@@ -0,0 +1,63 @@
+#ifndef ClockFollower_h
+#define ClockFollower_h
+
+#include <Arduino.h>
+
+/**
+ * Estimates the tempo of an external midi clock. The timestamps of incoming
+ * clock messages are jittery (transport, polling), so instead of measuring
+ * single intervals a second order PLL tracks both the phase and the period of
+ * the clock: each tick corrects the prediction by a fraction of its error.
+ */
+namespace ClockFollower {
+  namespace {
+    const float phaseGain = 0.2;
+    const float periodGain = 0.01;
+    // A gap longer than this many periods (e.g. the clock was paused) makes
+    // the PLL start over instead of slowly adjusting to a bogus interval.
+    const byte maxGap = 4;
+
+    byte ppq = 24;
+    uint32_t count = 0;
+    uint32_t lastTime = 0;
+    uint32_t predictedTime = 0;
+    float period = 0; // μs
+  } // namespace
+
+  void reset(byte ppq = 24) {
+    ClockFollower::ppq = ppq;
+    count = 0;
+    period = 0;
+  }
+
+  void tick(uint32_t time) {
+    uint32_t interval = time - lastTime;
+    lastTime = time;
+    count++;
+
+    if (count == 1) return;
+
+    if (count == 2 || interval > period * maxGap) {
+      period = interval;
+      predictedTime = time;
+      count = 2;
+      return;
+    }
+
+    uint32_t expectedTime = predictedTime + (uint32_t)(period + 0.5f);
+    float error = (int32_t)(time - expectedTime);
+    predictedTime = expectedTime + (int32_t)(error * phaseGain);
+    period += error * periodGain;
+  }
+
+  // Whether enough ticks have been received to estimate the tempo.
+  bool isLocked() {
+    return count > 2;
+  }
+
+  float getTempo() {
+    return isLocked() ? 60000000.0 / (period * ppq) : 0;
+  }
+} // namespace ClockFollower
+
+#endif
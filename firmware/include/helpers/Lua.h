@@ -9,7 +9,6 @@
 #include <lauxlib.h>
 #include <lua.h>
 #include <lualib.h>
-#include <sdios.h>
 
 namespace Lua {
   using Bridge::Data;
@@ -18,7 +17,11 @@ namespace Lua {
   typedef void (*SetupHandler)();
 
   lua_State *L;
-  StdioStream file;
+  // Read directly (see `lua_compat_fread()`), so `luaL_loadfile()`'s buffer
+  // of whole sectors goes straight to the SD card instead of through the
+  // small buffer of a `StdioStream`.
+  FatFile file;
+  bool hasFileError = false;
   SetupHandler handleSetup;
 
   void onSetup(SetupHandler handler) {
@@ -224,7 +227,7 @@ namespace Lua {
       if (!Bridge::validateData(data, "is", 2)) return Bridge::respondError(id);
 
       char fileName[FileSystem::maxFileNameLength];
-      data.getString(1, fileName, FileSystem::maxTempFileNameLength);
+      data.getString(1, fileName, sizeof(fileName));
 
       if (!runFile(fileName)) Bridge::respondError(id);
 
@@ -236,7 +239,7 @@ namespace Lua {
       if (!Bridge::validateData(data, "is", 2)) return Bridge::respondError(id);
 
       char fileName[FileSystem::maxFileNameLength];
-      data.getString(1, fileName, FileSystem::maxTempFileNameLength);
+      data.getString(1, fileName, sizeof(fileName));
 
       int isHotReplaced = updateFile(fileName);
       Bridge::respond(id, isHotReplaced);
@@ -257,23 +260,29 @@ void lua_compat_print(const char *string) {
 }
 
 int lua_compat_fopen(const char *fileName) {
-  return Lua::file.fopen(fileName, "r") ? 1 : 0;
+  Lua::hasFileError = false;
+  return Lua::file.open(fileName, O_RDONLY) ? 1 : 0;
 }
 
 void lua_compat_fclose() {
-  Lua::file.fclose();
+  Lua::file.close();
 }
 
 int lua_compat_feof() {
-  return Lua::file.feof();
+  return Lua::file.curPosition() >= Lua::file.fileSize();
 }
 
 size_t lua_compat_fread(void *ptr, size_t size, size_t count) {
-  return Lua::file.fread(ptr, size, count);
+  int length = Lua::file.read(ptr, size * count);
+  if (length < 0) {
+    Lua::hasFileError = true;
+    return 0;
+  }
+  return length / size;
 }
 
 int lua_compat_ferror() {
-  return Lua::file.ferror();
+  return Lua::hasFileError;
 }
 }
 
@@ -0,0 +1,137 @@
+#ifndef MidiClock_h
+#define MidiClock_h
+
+#include <Arduino.h>
+#include <IntervalTimer.h>
+
+/**
+ * A drift-free clock generator. Instead of a periodic timer with a truncated
+ * integer period, each tick is scheduled at an absolute time kept in fixed
+ * point (1/2^16 μs) and the timer is re-armed as a one-shot for every tick. The
+ * fractional part of the period is carried over, so rounding never adds up.
+ */
+namespace MidiClock {
+  typedef void (*TickHandler)();
+
+  struct Stats {
+    uint32_t ticks;
+    int32_t lastError;    // μs, measured minus nominal tick time.
+    uint32_t maxError;    // μs, absolute.
+    float averageError;   // μs, absolute.
+  };
+
+  namespace {
+    const byte fractionBits = 16;
+
+    IntervalTimer timer;
+    TickHandler handleTick;
+    volatile bool isRunning = false;
+    byte ppq = 24;
+
+    uint64_t period;   // 1/2^16 μs
+    uint64_t nextTick; // 1/2^16 μs, only the lower 32 bits of μs are used.
+
+    float bpm = 120;
+    float targetBpm = 120;
+    float bpmStep = 0;
+    uint32_t rampTicks = 0;
+
+    uint32_t ticks = 0;
+    int32_t lastError = 0;
+    uint32_t maxError = 0;
+    uint64_t errorSum = 0;
+
+    uint64_t getPeriod(float bpm) {
+      return (60000000.0 * (1 << fractionBits)) / (bpm * ppq);
+    }
+
+    void handleTimer();
+
+    void arm() {
+      int32_t delay = (uint32_t)(nextTick >> fractionBits) - micros();
+      timer.begin(handleTimer, max(delay, 1));
+    }
+
+    void handleTimer() {
+      timer.end();
+
+      int32_t error = micros() - (uint32_t)(nextTick >> fractionBits);
+      uint32_t absoluteError = abs(error);
+      lastError = error;
+      maxError = max(maxError, absoluteError);
+      errorSum += absoluteError;
+      ticks++;
+
+      if (handleTick != NULL) handleTick();
+
+      if (rampTicks > 0) {
+        rampTicks--;
+        bpm = rampTicks == 0 ? targetBpm : bpm + bpmStep;
+        period = getPeriod(bpm);
+      }
+
+      nextTick += period;
+      if (isRunning) arm();
+    }
+  } // namespace
+
+  void onTick(TickHandler handler) {
+    handleTick = handler;
+  }
+
+  void start(float bpm, byte ppq) {
+    noInterrupts();
+    MidiClock::ppq = ppq;
+    MidiClock::bpm = targetBpm = bpm;
+    rampTicks = 0;
+    period = getPeriod(bpm);
+    nextTick = ((uint64_t)micros() << fractionBits) + period;
+    ticks = maxError = errorSum = lastError = 0;
+    isRunning = true;
+    arm();
+    interrupts();
+  }
+
+  void stop() {
+    noInterrupts();
+    isRunning = false;
+    timer.end();
+    interrupts();
+  }
+
+  // Change the tempo, either immediately or linearly over `rampDuration` ms.
+  // The clock keeps running, the new period applies from the next tick on.
+  void setTempo(float bpm, uint32_t rampDuration = 0) {
+    noInterrupts();
+    targetBpm = bpm;
+    if (rampDuration == 0) {
+      MidiClock::bpm = bpm;
+      rampTicks = 0;
+      period = getPeriod(bpm);
+    } else {
+      // Approximate the ramp's tick count with the average tick period.
+      float averagePeriod = 60000.0 / (((MidiClock::bpm + bpm) / 2) * ppq);
+      rampTicks = max(rampDuration / averagePeriod, 1.0f);
+      bpmStep = (bpm - MidiClock::bpm) / rampTicks;
+    }
+    interrupts();
+  }
+
+  float getTempo() {
+    return bpm;
+  }
+
+  Stats getStats() {
+    noInterrupts();
+    Stats stats = {
+      ticks,
+      lastError,
+      maxError,
+      ticks > 0 ? (float)errorSum / ticks : 0,
+    };
+    interrupts();
+    return stats;
+  }
+} // namespace MidiClock
+
+#endif
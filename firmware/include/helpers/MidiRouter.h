@@ -0,0 +1,175 @@
+#ifndef MidiRouter_h
+#define MidiRouter_h
+
+#include <Arduino.h>
+
+/**
+ * A static routing table for midi connections that don't need any logic (plain
+ * thru, transpose, channel filter/remap). Matching input is forwarded right
+ * where the drivers deliver it, so it never has to enter the lua VM. All
+ * indexes, cables and channels are zero-based (except channel 0 = any).
+ * Notes that are held on a route's output are released when the route is
+ * removed, so changing a route never leaves stuck notes behind.
+ */
+namespace MidiRouter {
+  const byte maxRoutes = 64;
+  const byte anyCable = 255;
+  const byte anyChannel = 0;
+  const byte maxHeldNotes = 128;
+
+  struct Route {
+    uint16_t id;
+    byte input;
+    byte inputCable;
+    byte inputChannel;
+    byte output;
+    byte outputCable;   // `anyCable` keeps the input's cable.
+    byte outputChannel; // `anyChannel` keeps the input's channel.
+    int8_t transpose;
+    // Also let lua handle the input, e.g. if a patch listens to it as well.
+    bool keepInput;
+  };
+
+  typedef void (*SendHandler
+  )(byte index, byte type, byte data1, byte data2, byte channel, byte cable);
+
+  // A note on that has been forwarded by a route, as it was sent.
+  struct HeldNote {
+    uint16_t routeId;
+    byte output;
+    byte note;
+    byte channel;
+    byte cable;
+  };
+
+  namespace {
+    Route routes[maxRoutes];
+    byte routesCount = 0;
+    uint16_t nextId = 1;
+    SendHandler handleSend;
+    HeldNote heldNotes[maxHeldNotes];
+    byte heldNotesCount = 0;
+
+    bool isNote(byte type) {
+      // Note off, note on and polyphonic aftertouch.
+      return type == 0x80 || type == 0x90 || type == 0xA0;
+    }
+
+    void releaseNote(const HeldNote &heldNote) {
+      for (byte i = 0; i < heldNotesCount; i++) {
+        const HeldNote &held = heldNotes[i];
+        bool isSame = held.routeId == heldNote.routeId &&
+                      held.note == heldNote.note &&
+                      held.channel == heldNote.channel &&
+                      held.cable == heldNote.cable;
+        if (!isSame) continue;
+        heldNotes[i] = heldNotes[--heldNotesCount];
+        return;
+      }
+    }
+
+    void holdNote(const HeldNote &heldNote) {
+      releaseNote(heldNote); // A repeated note on is only held once.
+      // If there are too many held notes, the note simply isn't released.
+      if (heldNotesCount < maxHeldNotes) heldNotes[heldNotesCount++] = heldNote;
+    }
+
+    // Send a note off for each note held by the route (or by any route if
+    // `routeId` is zero).
+    void releaseNotes(uint16_t routeId) {
+      byte i = 0;
+      while (i < heldNotesCount) {
+        const HeldNote held = heldNotes[i];
+        if (routeId != 0 && held.routeId != routeId) {
+          i++;
+          continue;
+        }
+        heldNotes[i] = heldNotes[--heldNotesCount];
+        if (handleSend != NULL)
+          handleSend(held.output, 0x80, held.note, 0, held.channel, held.cable);
+      }
+    }
+  } // namespace
+
+  void onSend(SendHandler handler) {
+    handleSend = handler;
+  }
+
+  // Returns the route's id or zero if all routes are in use.
+  uint16_t add(Route route) {
+    if (routesCount >= maxRoutes) return 0;
+    route.id = nextId++;
+    routes[routesCount++] = route;
+    return route.id;
+  }
+
+  bool remove(uint16_t id) {
+    for (byte i = 0; i < routesCount; i++) {
+      if (routes[i].id != id) continue;
+      releaseNotes(id);
+      routes[i] = routes[--routesCount];
+      return true;
+    }
+    return false;
+  }
+
+  void clear() {
+    releaseNotes(0);
+    routesCount = 0;
+  }
+
+  // Forward the message to all matching routes. Returns whether the message
+  // has been consumed and shouldn't be passed on to lua.
+  bool route(
+    byte index, byte type, byte data1, byte data2, byte channel, byte cable
+  ) {
+    bool isRouted = false;
+    bool keepInput = false;
+    bool isChannelMessage = type < 0xF0;
+
+    for (byte i = 0; i < routesCount; i++) {
+      const Route &route = routes[i];
+      if (route.input != index) continue;
+      if (route.inputCable != anyCable && route.inputCable != cable) continue;
+      if (
+        route.inputChannel != anyChannel &&
+        (!isChannelMessage || route.inputChannel != channel)
+      )
+        continue;
+
+      isRouted = true;
+      keepInput |= route.keepInput;
+
+      byte outputData1 = data1;
+      if (route.transpose != 0 && isNote(type)) {
+        int note = data1 + route.transpose;
+        if (note < 0 || note > 127) continue; // Drop notes out of range.
+        outputData1 = note;
+      }
+
+      bool remapsChannel = route.outputChannel != anyChannel;
+      byte outputChannel =
+        remapsChannel && isChannelMessage ? route.outputChannel : channel;
+      byte outputCable =
+        route.outputCable != anyCable ? route.outputCable : cable;
+
+      HeldNote heldNote = {
+        route.id, route.output, outputData1, outputChannel, outputCable
+      };
+      if (type == 0x90 && data2 > 0) {
+        holdNote(heldNote);
+      } else if (type == 0x80 || type == 0x90) {
+        releaseNote(heldNote);
+      }
+
+      if (handleSend == NULL) continue;
+      handleSend(
+        route.output, type, outputData1, data2, outputChannel, outputCable
+      );
+    }
+
+    return isRouted && !keepInput;
+  }
+} // namespace MidiRouter
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef Profiler_h
+#define Profiler_h
+
+#include <Arduino.h>
+#include <Bridge.h>
+#include <Logger.h>
+
+/**
+ * Measures how long each subsystem of `loop()` takes. Durations are collected
+ * in log2 histograms (bucket `n` holds durations < 2^n μs), one per section and
+ * per one second window. The last `maxWindows` windows are kept in a ring, so
+ * the stats always describe the last few seconds without having to be reset.
+ */
+namespace Profiler {
+  using Bridge::Data;
+  using Bridge::RequestId;
+
+  enum Section {
+    SectionBridge,
+    SectionButtons,
+    SectionEncoders,
+    SectionMidi,
+    SectionTimer,
+    SectionDisplays,
+    // The interval between two `loop()` calls, includes everything above.
+    SectionLoop,
+    SectionsCount
+  };
+
+  typedef void (*UpdateHandler)();
+
+  const byte maxBuckets = 20; // The last bucket collects everything >= 2^18μs.
+  const byte maxWindows = 8;
+  const uint32_t windowDuration = 1000000; // μs
+
+  struct Histogram {
+    uint32_t counts[maxBuckets];
+    uint32_t max;
+  };
+
+  namespace {
+    Histogram windows[maxWindows][SectionsCount];
+    byte currentWindow = 0;
+    uint32_t windowStart = 0;
+    uint32_t lastLoopStart = 0;
+
+    byte getBucket(uint32_t duration) {
+      byte bucket = duration == 0 ? 0 : 32 - __builtin_clz(duration);
+      return min(bucket, maxBuckets - 1);
+    }
+
+    void record(Section section, uint32_t duration) {
+      Histogram &histogram = windows[currentWindow][section];
+      histogram.counts[getBucket(duration)]++;
+      histogram.max = max(histogram.max, duration);
+    }
+
+#if defined(DEBUG) && defined(DEBUG_LOOP)
+    void logWindow(Histogram *window) {
+      uint32_t maxInterval = window[SectionLoop].max;
+      const char *color = maxInterval < 100 ? "success"
+        : maxInterval < 500                 ? "warn"
+                                            : "error";
+
+      Logger::beginInfo();
+      Logger::serial->printf(
+        F("{gray Loop interval:} {%s %dμs}\n"), color, maxInterval
+      );
+      Logger::endInfo();
+    }
+#endif
+
+    void nextWindow() {
+#if defined(DEBUG) && defined(DEBUG_LOOP)
+      logWindow(windows[currentWindow]);
+#endif
+      currentWindow = (currentWindow + 1) % maxWindows;
+      memset(windows[currentWindow], 0, sizeof(windows[currentWindow]));
+    }
+
+    // Merge all windows of the ring and return the upper bound (in μs) of the
+    // bucket containing the requested percentile.
+    uint32_t getPercentile(Section section, byte percentile) {
+      uint32_t counts[maxBuckets] = {0};
+      uint32_t total = 0;
+      for (byte i = 0; i < maxWindows; i++) {
+        for (byte j = 0; j < maxBuckets; j++) {
+          counts[j] += windows[i][section].counts[j];
+          total += windows[i][section].counts[j];
+        }
+      }
+
+      if (total == 0) return 0;
+
+      uint32_t threshold = ((uint64_t)total * percentile + 99) / 100;
+      uint32_t sum = 0;
+      for (byte j = 0; j < maxBuckets; j++) {
+        sum += counts[j];
+        if (sum >= threshold) return j == 0 ? 0 : 1UL << j;
+      }
+      return 1UL << (maxBuckets - 1);
+    }
+
+    uint32_t getMax(Section section) {
+      uint32_t result = 0;
+      for (byte i = 0; i < maxWindows; i++) {
+        result = max(result, windows[i][section].max);
+      }
+      return result;
+    }
+
+    // Send p50, p99 and max (in μs) for each section, in the order of the
+    // `Section` enum.
+    void sendStats() {
+      OSCMessage message("/n/stats/loop");
+      for (byte i = 0; i < SectionsCount; i++) {
+        Section section = static_cast<Section>(i);
+        message.add((int)getPercentile(section, 50));
+        message.add((int)getPercentile(section, 99));
+        message.add((int)getMax(section));
+      }
+      Bridge::sendOscMessage(message);
+    }
+  } // namespace
+
+  void begin() {
+    windowStart = lastLoopStart = micros();
+
+    Bridge::addMethod("/stats/loop", [](Data &data) {
+      RequestId id = data.getInt(0);
+      if (!Bridge::validateData(data, "i", 1)) return Bridge::respondError(id);
+      sendStats();
+      Bridge::respond(id);
+    });
+
+    Bridge::addMethod("/stats/reset", [](Data &data) {
+      RequestId id = data.getInt(0);
+      if (!Bridge::validateData(data, "i", 1)) return Bridge::respondError(id);
+      memset(windows, 0, sizeof(windows));
+      Bridge::respond(id);
+    });
+  }
+
+  void beginLoop() {
+    uint32_t now = micros();
+    record(SectionLoop, now - lastLoopStart);
+    lastLoopStart = now;
+
+    if (now - windowStart >= windowDuration) {
+      nextWindow();
+      windowStart = now;
+    }
+  }
+
+  void measure(Section section, UpdateHandler update) {
+    uint32_t start = micros();
+    update();
+    record(section, micros() - start);
+  }
+} // namespace Profiler
+
+#endif
@@ -3,9 +3,14 @@
 
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <Display.h>
+#include <FileSystem.h>
 #include <Logger.h>
 #include <fonts/vevey_pixel_12pt.h>
+#include <fonts/vevey_pixel_12pt_atlas.h>
+#include <helpers/Bitmaps.h>
 #include <helpers/Lua.h>
+#include <lua/MidiLib.h>
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 32
@@ -17,8 +22,8 @@ namespace DisplaysLib {
   using Logger::beginError;
   using Logger::endError;
   using Logger::serial;
+  using Logger::warn;
 
-  typedef Adafruit_SSD1306 Display;
   const byte maxDisplays = 3;
   Display displays[maxDisplays] = {
     Display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET),
@@ -26,11 +31,25 @@ namespace DisplaysLib {
     Display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire2, OLED_RESET)};
 
   int needsUpdate[maxDisplays] = {false};
-  // A display update is ~12ms. If all three displays need an update 24fps
-  // would still leave enough time to draw all of them.
-  byte fps = 24;
-  uint32_t frameDuration = 1000 / fps; // ms
-  uint32_t lastFrameTime = 0;
+
+  // The displays' frames are staggered, every `frameDuration / maxDisplays`
+  // the next display (round-robin) may start a frame. The frame rate drops
+  // from `maxFps` to `minFps` as the midi load rises, so midi gets more time.
+  const byte maxFps = 24;
+  const byte minFps = 8;
+  const uint16_t lowMidiLoad = 200;   // messages per second
+  const uint16_t highMidiLoad = 2000; // messages per second
+  byte fps = maxFps;
+  uint32_t lastSlotTime = 0;
+  byte frameDisplay = 0;
+
+  // A frame is sent in chunks of ~0.7ms (see `Display`), each loop sends
+  // chunks (round-robin over all displays) as long as the next one still fits
+  // into this budget. A chunk's cost is measured, holding the peak (decaying
+  // slowly) so a slow bus isn't underestimated.
+  uint32_t loopBudget = 1000; // μs
+  uint32_t chunkCost = 700;   // μs
+  byte chunkDisplay = 0;
 
   void initializeDisplay(Display *display) {
     display->clearDisplay();
@@ -63,19 +82,232 @@ namespace DisplaysLib {
     }
   }
 
-  void update() {
+  void updateFps() {
+    uint16_t load = constrain(MidiLib::getLoad(), lowMidiLoad, highMidiLoad);
+    fps = map(load, lowMidiLoad, highMidiLoad, maxFps, minFps);
+  }
+
+  void startFrames() {
     uint32_t now = millis();
-    if (now - lastFrameTime >= frameDuration) {
-      for (int i = 0; i < maxDisplays; i++) {
-        if (!needsUpdate[i]) continue;
+    uint32_t slotDuration = 1000 / fps / maxDisplays;
+    if (now - lastSlotTime < slotDuration) return;
+
+    lastSlotTime = now;
+    // A display that is still busy with the last frame gets the update with
+    // one of its next frames.
+    Display &display = displays[frameDisplay];
+    if (needsUpdate[frameDisplay] && !display.getIsFlushing()) {
+      display.startFlush();
+      needsUpdate[frameDisplay] = false;
+    }
+    frameDisplay = (frameDisplay + 1) % maxDisplays;
+  }
+
+  void sendChunks() {
+    uint32_t start = micros();
+    bool hasSent = false;
+    // Stop once a whole round finds no display with anything left to send.
+    byte idleDisplays = 0;
+    while (idleDisplays < maxDisplays) {
+      Display &display = displays[chunkDisplay];
+      chunkDisplay = (chunkDisplay + 1) % maxDisplays;
+
+      if (!display.getIsFlushing()) {
+        idleDisplays++;
+        continue;
+      }
+
+      // At least one chunk is sent each loop, so flushing never stalls.
+      uint32_t chunkStart = micros();
+      if (hasSent && chunkStart - start + chunkCost > loopBudget) break;
+
+      display.flushChunk();
+      uint32_t cost = micros() - chunkStart;
+      chunkCost = max(cost, chunkCost - chunkCost / 8);
+      hasSent = true;
+      idleDisplays = 0;
+    }
+  }
+
+  void update() {
+    updateFps();
+    startFrames();
+    sendChunks();
+  }
+
+  const FontAtlas::Font *font = &vevey_pixel_12pt_atlas;
+
+  // `y` is the baseline, text beyond `width` (if not zero) is clipped.
+  void drawText(
+    Display *display,
+    const char *text,
+    byte color,
+    int16_t x = 0,
+    int16_t y = 17,
+    int16_t width = 0
+  ) {
+    int16_t clipEnd = width > 0 ? x + width - 1 : INT16_MAX;
+    display->drawText(font, x, y, text, color, x, clipEnd);
+  }
+
+  void drawLine(
+    Display *display, byte x0, byte y0, byte x1, byte y1, byte color
+  ) {
+    if (x0 == x1) {
+      display->drawFastVLine(x0, y0, abs(y1 - y0), color);
+    } else if (y0 == y1) {
+      display->drawFastHLine(x0, y0, abs(x1 - x0), color);
+    } else {
+      display->drawLine(x0, y0, x1, y1, color);
+    }
+  }
+
+  void drawTriangle(
+    Display *display,
+    byte x0,
+    byte y0,
+    byte x1,
+    byte y1,
+    byte x2,
+    byte y2,
+    byte color,
+    bool fill
+  ) {
+    if (fill) {
+      display->fillTriangle(x0, y0, x1, y1, x2, y2, color);
+    } else {
+      display->drawTriangle(x0, y0, x1, y1, x2, y2, color);
+    }
+  }
 
-        Display *display = getDisplay(i);
-        if (display != NULL) display->display();
+  void drawRectangle(
+    Display *display,
+    byte x,
+    byte y,
+    byte width,
+    byte height,
+    byte color,
+    bool fill
+  ) {
+    if (fill) {
+      display->fillRect(x, y, width, height, color);
+    } else {
+      display->drawRect(x, y, width, height, color);
+    }
+  }
+
+  void drawRoundedRectangle(
+    Display *display,
+    byte x,
+    byte y,
+    byte width,
+    byte height,
+    byte radius,
+    byte color,
+    bool fill
+  ) {
+    if (fill) {
+      display->fillRoundRect(x, y, width, height, radius, color);
+    } else {
+      display->drawRoundRect(x, y, width, height, radius, color);
+    }
+  }
 
-        needsUpdate[i] = false;
+  void drawCircle(
+    Display *display, byte x, byte y, byte radius, byte color, bool fill
+  ) {
+    if (fill) {
+      display->fillCircle(x, y, radius, color);
+    } else {
+      display->drawCircle(x, y, radius, color);
+    }
+  }
+
+  // The commands of `Displays.draw()`, keep in sync with `Display.Command` in
+  // `ui/components/Display.lua`.
+  enum Command {
+    CommandPixel = 1,
+    CommandLine,
+    CommandTriangle,
+    CommandRectangle,
+    CommandRoundedRectangle,
+    CommandCircle,
+    CommandText,
+    CommandClear,
+    CommandBitmap,
+  };
+
+  void drawBitmap(
+    Display *display,
+    byte id,
+    int16_t x,
+    int16_t y,
+    byte color,
+    bool opaque,
+    byte sourceX,
+    byte sourceY,
+    byte width,
+    byte height
+  ) {
+    Bitmap *bitmap = Bitmaps::get(id);
+    if (bitmap == NULL) {
+      beginError();
+      serial->printf(F("Bitmap #%d doesn't exist."), id);
+      endError();
+      return;
+    }
+    display->blit(
+      *bitmap, x, y, color, opaque, sourceX, sourceY, width, height
+    );
+  }
+
+  // Skip whitespace and comments and read the next number of a PBM header.
+  int readPbmNumber(FatFile &file) {
+    int c = file.read();
+    while (c == '#' || isspace(c)) {
+      if (c == '#') {
+        while (c != '\n' && c != -1) c = file.read();
       }
-      lastFrameTime = now;
+      c = file.read();
+    }
+
+    int number = -1;
+    while (isdigit(c)) {
+      number = max(number, 0) * 10 + (c - '0');
+      c = file.read();
     }
+    return number; // The single whitespace after the number is consumed.
+  }
+
+  // Load a binary PBM (P4) image: rows of `(width + 7) / 8` bytes, the most
+  // significant bit is the leftmost pixel. Returns the bitmap's id or zero.
+  byte loadBitmap(const char *fileName) {
+    FatFile file;
+    if (!file.open(fileName, O_READ)) return 0;
+
+    byte id = 0;
+    if (file.read() == 'P' && file.read() == '4') {
+      int width = readPbmNumber(file);
+      int height = readPbmNumber(file);
+      if (width > 0 && width <= 255 && height > 0)
+        id = Bitmaps::add(width, height);
+    }
+
+    Bitmap *bitmap = Bitmaps::get(id);
+    if (bitmap != NULL) {
+      uint8_t row[32];
+      uint8_t rowSize = (bitmap->width + 7) / 8;
+      for (uint8_t y = 0; y < bitmap->height; y++) {
+        if (file.read(row, rowSize) != rowSize) break;
+        uint8_t *page = bitmap->data + (y / 8) * bitmap->width;
+        for (uint8_t x = 0; x < bitmap->width; x++) {
+          if (row[x / 8] & (0x80 >> (x & 7))) page[x] |= 1 << (y & 7);
+        }
+      }
+    }
+
+    file.close();
+    return id;
   }
 
   namespace lib {
@@ -83,13 +315,120 @@ namespace DisplaysLib {
       byte index = luaL_checknumber(L, 1) - 1; // Use zero-based index.
       const char *text = luaL_checkstring(L, 2);
       byte color = luaL_checknumber(L, 3);
+      int16_t x = luaL_optnumber(L, 4, 0);
+      int16_t y = luaL_optnumber(L, 5, 17);
+      int16_t width = luaL_optnumber(L, 6, 0);
+
+      Display *display = getDisplay(index);
+      if (display != NULL) drawText(display, text, color, x, y, width);
+      return 0;
+    }
+
+    int measureText(lua_State *L) {
+      const char *text = luaL_checkstring(L, 1);
+      lua_pushnumber(L, FontAtlas::measure(font, text));
+      return 1;
+    }
+
+    void pushBitmapId(lua_State *L, byte id) {
+      if (id == 0) {
+        warn("bitmap is too big or there is no room left");
+        lua_pushnil(L);
+      } else {
+        lua_pushnumber(L, id);
+      }
+    }
+
+    // Create a bitmap from a list of rows, in which each character other than
+    // a space or a dot is a set pixel, e.g. `{ '.##.', '#..#', '.##.' }`.
+    int createBitmap(lua_State *L) {
+      luaL_checktype(L, 1, LUA_TTABLE);
+
+      int height = lua_objlen(L, 1);
+      size_t width = 0;
+      for (int i = 1; i <= height; i++) {
+        lua_rawgeti(L, 1, i);
+        width = max(width, lua_objlen(L, -1));
+        lua_pop(L, 1);
+      }
+
+      if (height == 0 || height > Bitmaps::maxHeight)
+        return luaL_error(L, "bitmap height must be 1-%d", Bitmaps::maxHeight);
+      if (width == 0 || width > 255)
+        return luaL_error(L, "bitmap width must be 1-255");
+
+      byte id = Bitmaps::add(width, height);
+      Bitmap *bitmap = Bitmaps::get(id);
+
+      for (int y = 0; bitmap != NULL && y < bitmap->height; y++) {
+        lua_rawgeti(L, 1, y + 1);
+        size_t length;
+        const char *row = lua_tolstring(L, -1, &length);
+        uint8_t *page = bitmap->data + (y / 8) * width;
+        for (size_t x = 0; row != NULL && x < length; x++) {
+          if (row[x] != ' ' && row[x] != '.') page[x] |= 1 << (y & 7);
+        }
+        lua_pop(L, 1);
+      }
+
+      pushBitmapId(L, id);
+      return 1;
+    }
+
+    int loadBitmap(lua_State *L) {
+      const char *fileName = luaL_checkstring(L, 1);
+      if (!FileSystem::sd.exists(fileName))
+        return luaL_error(L, "file %s doesn't exist", fileName);
+
+      pushBitmapId(L, DisplaysLib::loadBitmap(fileName));
+      return 1;
+    }
+
+    int captureBitmap(lua_State *L) {
+      byte index = luaL_checknumber(L, 1) - 1; // Use zero-based index.
+      int16_t x = luaL_checknumber(L, 2);
+      int16_t y = luaL_checknumber(L, 3);
+      byte width = luaL_checknumber(L, 4);
+      byte height = luaL_checknumber(L, 5);
 
       Display *display = getDisplay(index);
       if (display == NULL) return 0;
 
-      display->setCursor(0, 17);
-      display->setTextColor(color);
-      display->print(text);
+      byte id = Bitmaps::add(width, height);
+      Bitmap *bitmap = Bitmaps::get(id);
+      if (bitmap != NULL) display->capture(*bitmap, x, y);
+      pushBitmapId(L, id);
+      return 1;
+    }
+
+    int removeBitmap(lua_State *L) {
+      lua_pushboolean(L, Bitmaps::remove(luaL_checknumber(L, 1)));
+      return 1;
+    }
+
+    int clearBitmaps(lua_State *L) {
+      Bitmaps::clear();
+      return 0;
+    }
+
+    int drawBitmap(lua_State *L) {
+      byte index = luaL_checknumber(L, 1) - 1; // Use zero-based index.
+      byte id = luaL_checknumber(L, 2);
+      int16_t x = luaL_checknumber(L, 3);
+      int16_t y = luaL_checknumber(L, 4);
+      byte color = luaL_checknumber(L, 5);
+      bool opaque = lua_toboolean(L, 6);
+      byte sourceX = luaL_optnumber(L, 7, 0);
+      byte sourceY = luaL_optnumber(L, 8, 0);
+      byte width = luaL_optnumber(L, 9, 0);
+      byte height = luaL_optnumber(L, 10, 0);
+
+      Display *display = getDisplay(index);
+      if (display == NULL) return 0;
+
+      DisplaysLib::drawBitmap(
+        display, id, x, y, color, opaque, sourceX, sourceY, width, height
+      );
       return 0;
     }
 
@@ -115,13 +454,7 @@ namespace DisplaysLib {
       Display *display = getDisplay(index);
       if (display == NULL) return 0;
 
-      if (x0 == x1) {
-        display->drawFastVLine(x0, y0, abs(y1 - y0), color);
-      } else if (y0 == y1) {
-        display->drawFastHLine(x0, y0, abs(x1 - x0), color);
-      } else {
-        display->drawLine(x0, y0, x1, y1, color);
-      }
+      DisplaysLib::drawLine(display, x0, y0, x1, y1, color);
       return 0;
     }
 
@@ -139,11 +472,7 @@ namespace DisplaysLib {
       Display *display = getDisplay(index);
       if (display == NULL) return 0;
 
-      if (fill) {
-        display->fillTriangle(x0, y0, x1, y1, x2, y2, color);
-      } else {
-        display->drawTriangle(x0, y0, x1, y1, x2, y2, color);
-      }
+      DisplaysLib::drawTriangle(display, x0, y0, x1, y1, x2, y2, color, fill);
       return 0;
     }
 
@@ -159,11 +488,7 @@ namespace DisplaysLib {
       Display *display = getDisplay(index);
       if (display == NULL) return 0;
 
-      if (fill) {
-        display->fillRect(x, y, width, height, color);
-      } else {
-        display->drawRect(x, y, width, height, color);
-      }
+      DisplaysLib::drawRectangle(display, x, y, width, height, color, fill);
       return 0;
     }
 
@@ -180,11 +505,9 @@ namespace DisplaysLib {
       Display *display = getDisplay(index);
       if (display == NULL) return 0;
 
-      if (fill) {
-        display->fillRoundRect(x, y, width, height, radius, color);
-      } else {
-        display->drawRoundRect(x, y, width, height, radius, color);
-      }
+      DisplaysLib::drawRoundedRectangle(
+        display, x, y, width, height, radius, color, fill
+      );
       return 0;
     }
 
@@ -199,10 +522,137 @@ namespace DisplaysLib {
       Display *display = getDisplay(index);
       if (display == NULL) return 0;
 
-      if (fill) {
-        display->fillCircle(x, y, radius, color);
-      } else {
-        display->drawCircle(x, y, radius, color);
+      DisplaysLib::drawCircle(display, x, y, radius, color, fill);
+      return 0;
+    }
+
+    // Read the next value of the command list (at stack index 2).
+    lua_Number nextNumber(lua_State *L, int &position) {
+      lua_rawgeti(L, 2, position++);
+      lua_Number value = lua_tonumber(L, -1);
+      lua_pop(L, 1);
+      return value;
+    }
+
+    bool nextBoolean(lua_State *L, int &position) {
+      lua_rawgeti(L, 2, position++);
+      bool value = lua_toboolean(L, -1);
+      lua_pop(L, 1);
+      return value;
+    }
+
+    // Draw a flat list of commands, each one followed by the arguments of its
+    // single function (without the index), e.g.: `{ CommandClear,
+    // CommandText, 'Hello', 1, 0, 17, 0, CommandPixel, 0, 0, 1 }`. Optional
+    // arguments can't be omitted.
+    int draw(lua_State *L) {
+      byte index = luaL_checknumber(L, 1) - 1; // Use zero-based index.
+      luaL_checktype(L, 2, LUA_TTABLE);
+
+      Display *display = getDisplay(index);
+      if (display == NULL) return 0;
+
+      int length = lua_objlen(L, 2);
+      int position = 1;
+      while (position <= length) {
+        byte command = nextNumber(L, position);
+        switch (command) {
+          case CommandPixel: {
+            byte x = nextNumber(L, position);
+            byte y = nextNumber(L, position);
+            byte color = nextNumber(L, position);
+            display->drawPixel(x, y, color);
+            break;
+          }
+          case CommandLine: {
+            byte x0 = nextNumber(L, position);
+            byte y0 = nextNumber(L, position);
+            byte x1 = nextNumber(L, position);
+            byte y1 = nextNumber(L, position);
+            byte color = nextNumber(L, position);
+            DisplaysLib::drawLine(display, x0, y0, x1, y1, color);
+            break;
+          }
+          case CommandTriangle: {
+            byte x0 = nextNumber(L, position);
+            byte y0 = nextNumber(L, position);
+            byte x1 = nextNumber(L, position);
+            byte y1 = nextNumber(L, position);
+            byte x2 = nextNumber(L, position);
+            byte y2 = nextNumber(L, position);
+            byte color = nextNumber(L, position);
+            bool fill = nextBoolean(L, position);
+            DisplaysLib::drawTriangle(
+              display, x0, y0, x1, y1, x2, y2, color, fill
+            );
+            break;
+          }
+          case CommandRectangle: {
+            byte x = nextNumber(L, position);
+            byte y = nextNumber(L, position);
+            byte width = nextNumber(L, position);
+            byte height = nextNumber(L, position);
+            byte color = nextNumber(L, position);
+            bool fill = nextBoolean(L, position);
+            DisplaysLib::drawRectangle(
+              display, x, y, width, height, color, fill
+            );
+            break;
+          }
+          case CommandRoundedRectangle: {
+            byte x = nextNumber(L, position);
+            byte y = nextNumber(L, position);
+            byte width = nextNumber(L, position);
+            byte height = nextNumber(L, position);
+            byte radius = nextNumber(L, position);
+            byte color = nextNumber(L, position);
+            bool fill = nextBoolean(L, position);
+            DisplaysLib::drawRoundedRectangle(
+              display, x, y, width, height, radius, color, fill
+            );
+            break;
+          }
+          case CommandCircle: {
+            byte x = nextNumber(L, position);
+            byte y = nextNumber(L, position);
+            byte radius = nextNumber(L, position);
+            byte color = nextNumber(L, position);
+            bool fill = nextBoolean(L, position);
+            DisplaysLib::drawCircle(display, x, y, radius, color, fill);
+            break;
+          }
+          case CommandText: {
+            lua_rawgeti(L, 2, position++);
+            const char *text = lua_tostring(L, -1);
+            byte color = nextNumber(L, position);
+            int16_t x = nextNumber(L, position);
+            int16_t y = nextNumber(L, position);
+            int16_t width = nextNumber(L, position);
+            if (text != NULL) drawText(display, text, color, x, y, width);
+            lua_pop(L, 1); // Keep the text referenced until it is drawn.
+            break;
+          }
+          case CommandClear:
+            display->clearDisplay();
+            break;
+          case CommandBitmap: {
+            byte id = nextNumber(L, position);
+            int16_t x = nextNumber(L, position);
+            int16_t y = nextNumber(L, position);
+            byte color = nextNumber(L, position);
+            bool opaque = nextBoolean(L, position);
+            byte sourceX = nextNumber(L, position);
+            byte sourceY = nextNumber(L, position);
+            byte width = nextNumber(L, position);
+            byte height = nextNumber(L, position);
+            DisplaysLib::drawBitmap(
+              display, id, x, y, color, opaque, sourceX, sourceY, width, height
+            );
+            break;
+          }
+          default:
+            return luaL_error(L, "unknown display command %d", command);
+        }
       }
       return 0;
     }
@@ -219,19 +669,43 @@ namespace DisplaysLib {
       if (display != NULL) display->clearDisplay();
       return 0;
     }
+
+    int setLoopBudget(lua_State *L) {
+      loopBudget = luaL_checknumber(L, 1);
+      return 0;
+    }
+
+    int getFps(lua_State *L) {
+      lua_pushnumber(L, fps);
+      return 1;
+    }
+
   } // namespace lib
 
   void install() {
+    // The bitmaps of a previous Lua state aren't referenced anymore.
+    Bitmaps::clear();
+
     luaL_Reg lib[] = {
       {"text", lib::text},
+      {"measureText", lib::measureText},
       {"drawPixel", lib::drawPixel},
       {"drawLine", lib::drawLine},
       {"drawTriangle", lib::drawTriangle},
       {"drawRectangle", lib::drawRectangle},
       {"drawRoundedRectangle", lib::drawRoundedRectangle},
       {"drawCircle", lib::drawCircle},
+      {"createBitmap", lib::createBitmap},
+      {"loadBitmap", lib::loadBitmap},
+      {"captureBitmap", lib::captureBitmap},
+      {"removeBitmap", lib::removeBitmap},
+      {"clearBitmaps", lib::clearBitmaps},
+      {"drawBitmap", lib::drawBitmap},
+      {"draw", lib::draw},
       {"update", lib::update},
       {"clear", lib::clear},
+      {"setLoopBudget", lib::setLoopBudget},
+      {"getFps", lib::getFps},
       {NULL, NULL}};
 
     luaL_register(Lua::L, "Displays", lib);
@@ -58,6 +58,7 @@ namespace FileSystemLib {
       file.open(fileName, FILE_WRITE);
       int result = file.write(content);
       file.close();
+      FileSystem::invalidateHash(fileName);
 
       lua_pushboolean(L, result > -1);
       return 1;
@@ -6,12 +6,15 @@
 #include <AnyMidiUsb.h>
 #include <AnyMidiUsbHub.h>
 #include <Bridge.h>
-#include <IntervalTimer.h>
 #include <Logger.h>
 #include <MIDI.h>
 #include <SPI.h>
+#include <SpscQueue.h>
 #include <USBHost_t36.h>
+#include <helpers/ClockFollower.h>
 #include <helpers/Lua.h>
+#include <helpers/MidiClock.h>
+#include <helpers/MidiRouter.h>
 #include <lua/TimerLib.h>
 
 // Midi via USB/Power port.
@@ -52,8 +55,11 @@ AnyMidiUsbHub midiDevice13(12, &hubMidi10);
 
 namespace MidiLib {
   using Logger::beginError;
+  using Logger::beginWarn;
   using Logger::endError;
+  using Logger::endWarn;
   using Logger::serial;
+  using Logger::warn;
 
   typedef AnyMidi Device;
   const byte maxDevices = 13;
@@ -73,16 +79,53 @@ namespace MidiLib {
     &midiDevice13
   };
 
-  int handleInputRef = -1;
+  int handleInputsRef = -1;
   int handleClockRef = -1;
-  IntervalTimer clockTimer;
+  int handleExternalStartRef = -1;
+  int handleExternalStopRef = -1;
   float bpm = 120.0;
   int ppq = 24;
   bool isPlaying = false;
+
+  // Inputs are collected during `update()` and passed to lua all at once, so a
+  // burst of messages only costs a single call into the VM.
+  const byte maxInputs = 64;
+  struct Input {
+    byte index;
+    byte type;
+    byte data1;
+    byte data2;
+    byte channel;
+    byte cable;
+  };
+  Input inputs[maxInputs];
+  byte inputsCount = 0;
+  // A flat table of all inputs' fields, reused for each call.
+  int inputsTableRef = -1;
+
+  // Received messages per second, smoothed over a few windows.
+  float load = 0;
+  const uint32_t loadWindow = 100; // ms
+  uint32_t loadWindowStart = 0;
+  uint32_t loadCount = 0;
+  // The device whose clock we follow, or -1 to use our own `MidiClock`.
+  int clockSource = -1;
   uint32_t currentTick = 0;
   // Metronome side is alternating between left and right each quarter note.
   bool metronomeSideIsLeft = true;
 
+  // Everything the midi clock and the timer events produce inside their
+  // interrupts is handed to the main loop through `clockEvents`, so serial and
+  // usb aren't accessed from two contexts at once. Both timers run on the same
+  // PIT interrupt, so they can't preempt each other and form a single producer.
+  enum ClockEventType { ClockEventTick, ClockEventMidi };
+  struct ClockEvent {
+    ClockEventType type;
+    uint32_t data;
+  };
+  SpscQueue<ClockEvent, 256> clockEvents;
+  volatile uint32_t droppedClockEvents = 0;
+
   Device *getDevice(byte index) {
     if (index >= maxDevices) {
       beginError();
@@ -94,68 +137,240 @@ namespace MidiLib {
     return devices[index];
   }
 
+  void flushInputs() {
+    if (inputsCount == 0) return;
+
+    byte count = inputsCount;
+    inputsCount = 0;
+
+    if (handleInputsRef == -1)
+      handleInputsRef = Lua::storeFunction("Midi", "handleInputs");
+
+    if (!Lua::getFunction(handleInputsRef)) return;
+
+    if (inputsTableRef == -1) {
+      lua_createtable(Lua::L, maxInputs * 6, 0);
+      inputsTableRef = luaL_ref(Lua::L, LUA_REGISTRYINDEX);
+    }
+
+    lua_rawgeti(Lua::L, LUA_REGISTRYINDEX, inputsTableRef);
+    int field = 1;
+    for (byte i = 0; i < count; i++) {
+      Input &input = inputs[i];
+      lua_pushnumber(Lua::L, input.index + 1); // Use one-based index.
+      lua_rawseti(Lua::L, -2, field++);
+      lua_pushnumber(Lua::L, input.type);
+      lua_rawseti(Lua::L, -2, field++);
+      lua_pushnumber(Lua::L, input.data1);
+      lua_rawseti(Lua::L, -2, field++);
+      lua_pushnumber(Lua::L, input.data2);
+      lua_rawseti(Lua::L, -2, field++);
+      // Channel is already a one-based index.
+      lua_pushnumber(Lua::L, input.channel);
+      lua_rawseti(Lua::L, -2, field++);
+      lua_pushnumber(Lua::L, input.cable + 1); // Use one-based index.
+      lua_rawseti(Lua::L, -2, field++);
+    }
+    lua_pushnumber(Lua::L, count);
+    Lua::check(lua_pcall(Lua::L, 2, 0, 0));
+  }
+
   void handleInput(
     byte index, byte type, byte data1, byte data2, byte channel, byte cable = 0
   ) {
+    if (MidiRouter::route(index, type, data1, data2, channel, cable)) return;
 
-    if (handleInputRef == -1)
-      handleInputRef = Lua::storeFunction("Midi", "handleInput");
+    if (inputsCount >= maxInputs) flushInputs();
+    inputs[inputsCount++] = {index, type, data1, data2, channel, cable};
+  }
 
-    if (!Lua::getFunction(handleInputRef)) return;
+  // Send from the main loop.
+  void send(
+    Device *device, byte type, byte data1, byte data2, byte channel, byte cable
+  ) {
+    // Interrupt-safe devices might also be sent to from the midi clock, so we
+    // must not be interrupted in the middle of a message.
+    bool isInterruptSafe = device->isInterruptSafe();
+    if (isInterruptSafe) noInterrupts();
+    device->send(type, data1, data2, channel, cable);
+    if (isInterruptSafe) interrupts();
+  }
 
-    lua_pushnumber(Lua::L, index + 1); // Use one-based index.
-    lua_pushnumber(Lua::L, type);
-    lua_pushnumber(Lua::L, data1);
-    lua_pushnumber(Lua::L, data2);
-    lua_pushnumber(Lua::L, channel); // Channel is already a one-based index.
-    lua_pushnumber(Lua::L, cable + 1); // Use one-based index.
-    Lua::check(lua_pcall(Lua::L, 6, 0, 0));
+  void pushClockEvent(ClockEventType type, uint32_t data) {
+    if (!clockEvents.push({type, data})) droppedClockEvents++;
   }
 
-  void handleTimerEvent(uint32_t data) {
+  // See `TimerLib::scheduleMidi()` for the data layout.
+  void unpackTimerEvent(
+    uint32_t data,
+    byte &deviceIndex,
+    byte &type,
+    byte &data1,
+    byte &data2,
+    byte &channel,
+    byte &cable
+  ) {
     uint32_t message = data >> 8;
     byte status = message >> 16;
-    byte type = status & 0xF0;
-    byte channel = (status & 15) + 1; // Channel is stored zero-based.
-    byte data1 = (message >> 8) & 127;
-    byte data2 = message & 127;
-    byte deviceIndex = (data >> 4) & 15;
-    byte cable = data & 15;
+    type = status & 0xF0;
+    channel = (status & 15) + 1; // Channel is stored zero-based.
+    data1 = (message >> 8) & 127;
+    data2 = message & 127;
+    deviceIndex = (data >> 4) & 15;
+    cable = data & 15;
+  }
 
-    AnyMidi *device = getDevice(deviceIndex);
-    if (device != NULL) device->send(type, data1, data2, channel, cable);
+  void handleRoutedMidi(
+    byte index, byte type, byte data1, byte data2, byte channel, byte cable
+  ) {
+    if (index < maxDevices)
+      send(devices[index], type, data1, data2, channel, cable);
   }
 
+  // Called inside an interrupt.
+  void handleTimerEvent(uint32_t data) {
+    byte deviceIndex, type, data1, data2, channel, cable;
+    unpackTimerEvent(data, deviceIndex, type, data1, data2, channel, cable);
+    if (deviceIndex >= maxDevices) return;
+
+    // Only devices that can handle it are sent to directly, everything else is
+    // sent from the main loop (see `handleClockEvents()`).
+    Device *device = devices[deviceIndex];
+    if (device->isInterruptSafe()) {
+      device->send(type, data1, data2, channel, cable);
+    } else {
+      pushClockEvent(ClockEventMidi, data);
+    }
+  }
+
+  // Called inside an interrupt.
   void handleMidiClock() {
-    // TODO: sync selected midi devices
-    usbMIDI.sendRealTime(usbMIDI.Clock);
+    pushClockEvent(ClockEventTick, currentTick);
     TimerLib::updateEvents(currentTick, true);
     currentTick++;
     TimerLib::currentTick = currentTick;
+  }
+
+  void handleClockEvents() {
+    ClockEvent event;
+    while (clockEvents.pop(event)) {
+      if (event.type == ClockEventTick) {
+        // TODO: sync selected midi devices
+        // Don't echo the clock back to where it came from.
+        if (clockSource != 0) usbMIDI.sendRealTime(usbMIDI.Clock);
+
+        // Notify after the last clock of each quarter note.
+        // TODO: check if connected to app
+        if ((event.data + 1) % ppq == 0) {
+          OSCMessage message("/n/midi/quarter");
+          message.add(metronomeSideIsLeft);
+          Bridge::sendOscMessage(message);
+          metronomeSideIsLeft = !metronomeSideIsLeft;
+        }
+      } else if (event.type == ClockEventMidi) {
+        byte deviceIndex, type, data1, data2, channel, cable;
+        unpackTimerEvent(
+          event.data, deviceIndex, type, data1, data2, channel, cable
+        );
+        send(devices[deviceIndex], type, data1, data2, channel, cable);
+      }
+    }
 
-    // TODO: check if connected to app
-    if (currentTick % ppq == 0) {
-      OSCMessage message("/n/midi/quarter");
-      message.add(metronomeSideIsLeft);
-      Bridge::sendOscMessage(message);
-      metronomeSideIsLeft = !metronomeSideIsLeft;
+    if (droppedClockEvents) {
+      noInterrupts();
+      uint32_t dropped = droppedClockEvents;
+      droppedClockEvents = 0;
+      interrupts();
+
+      beginWarn();
+      serial->printf(F("%d clock events dropped"), dropped);
+      endWarn();
     }
   }
 
+  void callExternalTransport(int &ref, const char *functionName) {
+    if (ref == -1) ref = Lua::storeFunction("Midi", functionName);
+    if (!Lua::getFunction(ref)) return;
+    Lua::check(lua_pcall(Lua::L, 0, 0, 0));
+  }
+
+  // Follow the clock of the selected clock source. Clock messages are consumed
+  // here, all other devices' clock messages are handled like any other input.
+  bool handleExternalClock(byte index, byte type, uint32_t time) {
+    if (index != clockSource) return false;
+
+    switch (type) {
+      case 0xF8:
+        ClockFollower::tick(time);
+        if (isPlaying) {
+          // Tick the same way our own clock would (from its interrupt).
+          noInterrupts();
+          handleMidiClock();
+          interrupts();
+        }
+        break;
+      case 0xFA:
+        noInterrupts();
+        currentTick = TimerLib::currentTick = 0;
+        interrupts();
+        // Fallthrough.
+      case 0xFB:
+        isPlaying = true;
+        callExternalTransport(handleExternalStartRef, "handleExternalStart");
+        break;
+      case 0xFC:
+        isPlaying = false;
+        callExternalTransport(handleExternalStopRef, "handleExternalStop");
+        break;
+    }
+
+    return true;
+  }
+
   void begin() {
     usbHost.begin();
     for (byte i = 0; i < maxDevices; i++) {
       devices[i]->begin();
       devices[i]->onInput(handleInput);
+      devices[i]->onClock(handleExternalClock);
     }
     TimerLib::onEvent(handleTimerEvent);
+    MidiClock::onTick(handleMidiClock);
+    MidiRouter::onSend(handleRoutedMidi);
   }
 
-  void update() {
+  // Read all pending input into the devices' rings. Cheap enough to be called
+  // in between other subsystems, so bursts don't pile up in the transports.
+  void poll() {
     usbHost.Task();
     for (byte i = 0; i < maxDevices; i++) {
-      devices[i]->update();
+      devices[i]->poll();
+    }
+  }
+
+  void updateLoad() {
+    uint32_t now = millis();
+    if (now - loadWindowStart < loadWindow) return;
+
+    float windowLoad = loadCount * 1000.0 / (now - loadWindowStart);
+    load = load * 0.5 + windowLoad * 0.5;
+    loadCount = 0;
+    loadWindowStart = now;
+  }
+
+  // Received messages per second, e.g. to back off with less important work.
+  float getLoad() {
+    return load;
+  }
+
+  void update() {
+    handleClockEvents();
+    poll();
+    for (byte i = 0; i < maxDevices; i++) {
+      loadCount += devices[i]->update();
     }
+    flushInputs();
+    updateLoad();
   }
 
   namespace lib {
@@ -168,8 +383,9 @@ namespace MidiLib {
       byte channel = lua_tonumber(L, 5); // Channel is always a one-based index.
       byte cable = lua_tonumber(L, 6) - 1; // Use zero-based index.
 
-      AnyMidi *device = getDevice(index);
-      if (device != NULL) device->send(type, data1, data2, channel, cable);
+      Device *device = getDevice(index);
+      if (device != NULL)
+        MidiLib::send(device, type, data1, data2, channel, cable);
       return 0;
     }
 
@@ -190,29 +406,135 @@ namespace MidiLib {
     }
 
     int start(lua_State *L) {
+      // An external clock starts us with its own start message.
+      if (clockSource != -1) return 0;
       // TODO: sync selected midi devices
       usbMIDI.sendRealTime(usbMIDI.Start);
-      clockTimer.begin(handleMidiClock, (60000000 / bpm) / ppq);
+      MidiClock::start(bpm, ppq);
       isPlaying = true;
       return 0;
     }
 
     int stop(lua_State *L) {
+      if (clockSource != -1) return 0;
       // TODO: sync selected midi devices
       usbMIDI.sendRealTime(usbMIDI.Stop);
-      clockTimer.end();
+      MidiClock::stop();
       isPlaying = false;
       return 0;
     }
 
     int setTempo(lua_State *L) {
       bpm = luaL_checknumber(L, 1);
-      clockTimer.update((60000000 / bpm) / ppq);
+      uint32_t rampDuration = luaL_optnumber(L, 2, 0);
+      if (isPlaying) {
+        MidiClock::setTempo(bpm, rampDuration);
+      }
       return 0;
     }
 
     int getTempo(lua_State *L) {
-      lua_pushnumber(L, bpm);
+      if (clockSource != -1) {
+        lua_pushnumber(L, ClockFollower::getTempo());
+      } else {
+        lua_pushnumber(L, isPlaying ? MidiClock::getTempo() : bpm);
+      }
+      return 1;
+    }
+
+    int setClockSource(lua_State *L) {
+      // Use one-based index, `nil` or 0 selects the internal clock.
+      int index = luaL_optint(L, 1, 0) - 1;
+      if (index >= maxDevices) return luaL_error(L, "invalid device index");
+      if (index == clockSource) return 0;
+
+      if (isPlaying && clockSource == -1) {
+        usbMIDI.sendRealTime(usbMIDI.Stop);
+        MidiClock::stop();
+      } else if (isPlaying) {
+        callExternalTransport(handleExternalStopRef, "handleExternalStop");
+      }
+      isPlaying = false;
+      clockSource = max(index, -1);
+      ClockFollower::reset(ppq);
+      return 0;
+    }
+
+    int getClockSource(lua_State *L) {
+      if (clockSource == -1) {
+        lua_pushnil(L);
+      } else {
+        lua_pushnumber(L, clockSource + 1); // Use one-based index.
+      }
+      return 1;
+    }
+
+    int getClockStats(lua_State *L) {
+      MidiClock::Stats stats = MidiClock::getStats();
+      lua_newtable(L);
+      lua_pushnumber(L, stats.ticks);
+      lua_setfield(L, -2, "ticks");
+      lua_pushnumber(L, stats.lastError);
+      lua_setfield(L, -2, "lastError");
+      lua_pushnumber(L, stats.maxError);
+      lua_setfield(L, -2, "maxError");
+      lua_pushnumber(L, stats.averageError);
+      lua_setfield(L, -2, "averageError");
+      return 1;
+    }
+
+    int getField(lua_State *L, const char *key, int defaultValue) {
+      lua_getfield(L, 1, key);
+      int value = lua_isnil(L, -1) ? defaultValue : lua_tointeger(L, -1);
+      lua_pop(L, 1);
+      return value;
+    }
+
+    int addRoute(lua_State *L) {
+      luaL_checktype(L, 1, LUA_TTABLE);
+
+      // Use zero-based indexes and cables. An omitted cable wraps around to
+      // `MidiRouter::anyCable`, an omitted channel (0) means any channel.
+      MidiRouter::Route route;
+      route.input = getField(L, "input", 0) - 1;
+      route.inputCable = getField(L, "inputCable", 0) - 1;
+      route.inputChannel = getField(L, "inputChannel", 0);
+      route.output = getField(L, "output", 0) - 1;
+      route.outputCable = getField(L, "outputCable", 0) - 1;
+      route.outputChannel = getField(L, "outputChannel", 0);
+      route.transpose = getField(L, "transpose", 0);
+      lua_getfield(L, 1, "keepInput");
+      route.keepInput = lua_toboolean(L, -1);
+      lua_pop(L, 1);
+
+      if (route.input >= maxDevices || route.output >= maxDevices)
+        return luaL_error(L, "invalid device index");
+
+      uint16_t id = MidiRouter::add(route);
+      if (id == 0) {
+        warn("all midi routes in use");
+        lua_pushnil(L);
+      } else {
+        lua_pushnumber(L, id);
+      }
+      return 1;
+    }
+
+    int removeRoute(lua_State *L) {
+      lua_pushboolean(L, MidiRouter::remove(luaL_checkint(L, 1)));
+      return 1;
+    }
+
+    int clearRoutes(lua_State *L) {
+      MidiRouter::clear();
+      return 0;
+    }
+
+    int getInputOverflows(lua_State *L) {
+      byte index = luaL_checkint(L, 1) - 1; // Use zero-based index.
+      Device *device = getDevice(index);
+      if (device == NULL) return 0;
+      lua_pushnumber(L, device->overflows);
       return 1;
     }
 
@@ -223,8 +545,23 @@ namespace MidiLib {
   } // namespace lib
 
   void install() {
-    handleInputRef = -1;
+    handleInputsRef = -1;
+    inputsTableRef = -1;
+    inputsCount = 0;
     handleClockRef = -1;
+    handleExternalStartRef = -1;
+    handleExternalStopRef = -1;
+
+    // Routes and the clock of a previous Lua state would otherwise keep
+    // running without anyone to handle or stop them.
+    MidiRouter::clear();
+    if (isPlaying && clockSource == -1) {
+      usbMIDI.sendRealTime(usbMIDI.Stop);
+      MidiClock::stop();
+    }
+    isPlaying = false;
+    clockSource = -1;
+    ClockFollower::reset(ppq);
 
     luaL_Reg lib[] = {
       {"__send", lib::send},
@@ -235,6 +572,13 @@ namespace MidiLib {
       {"getIsPlaying", lib::getIsPlaying},
       {"setTempo", lib::setTempo},
       {"getTempo", lib::getTempo},
+      {"getClockStats", lib::getClockStats},
+      {"addRoute", lib::addRoute},
+      {"removeRoute", lib::removeRoute},
+      {"clearRoutes", lib::clearRoutes},
+      {"getInputOverflows", lib::getInputOverflows},
+      {"setClockSource", lib::setClockSource},
+      {"getClockSource", lib::getClockSource},
       {NULL, NULL}
     };
 
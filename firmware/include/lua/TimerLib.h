@@ -2,6 +2,8 @@
 #define LuaTimerLib_h
 
 #include <Arduino.h>
+#include <EventQueue.h>
+#include <IntervalTimer.h>
 #include <Logger.h>
 #include <helpers/Lua.h>
 
@@ -15,13 +17,18 @@ namespace TimerLib {
   EventHandler handleEvent;
   uint32_t currentTick = 0; // updated by `Midi`.
 
-  struct MidiEvent {
-    uint32_t time;
-    uint32_t data;
-  };
+  // Events scheduled in ticks and in milliseconds are kept in separate queues,
+  // so each one can be dispatched against its own clock. Tick events are
+  // dispatched by the midi clock, time events (stored in μs) by `eventTimer`.
+  const uint16_t maxEvents = 512;
+  typedef EventQueue<maxEvents> MidiEventQueue;
+  MidiEventQueue tickEvents;
+  MidiEventQueue timeEvents;
 
-  const byte MAX_EVENTS = 255;
-  MidiEvent events[MAX_EVENTS];
+  // A one-shot timer, re-armed to the next due time event.
+  IntervalTimer eventTimer;
+  // Events further away re-arm the timer when it fires.
+  const uint32_t maxEventTimerDelay = 1000000; // μs
 
   uint32_t currentTime = 0;
 
@@ -30,21 +37,27 @@ namespace TimerLib {
   } // namespace
 
   void updateEvents(uint32_t time, bool useTicks) {
-    for (byte i = 0; i < MAX_EVENTS; i++) {
-      // Ignore free/empty events.
-      if (events[i].data == 0) continue;
+    MidiEventQueue &events = useTicks ? tickEvents : timeEvents;
+    MidiEventQueue::Event event;
+    while (events.popDue(time, event)) {
+      if (handleEvent != NULL) handleEvent(event.data);
+    }
+  }
 
-      bool eventUsesTicks = events[i].data & (1 << 31);
-      // Restore the MSB, see `LuaTimer::scheduleMidi()`.
-      uint32_t data = events[i].data | (1 << 31);
+  void armEventTimer();
 
-      if (useTicks && !eventUsesTicks) continue;
-      if (events[i].time > time) continue;
+  void handleEventTimer() {
+    eventTimer.end();
+    updateEvents(::micros(), false);
+    armEventTimer();
+  }
 
-      if (handleEvent != NULL) handleEvent(data);
-      // A data of zero acts as a flag for a free event.
-      events[i].data = 0;
-    }
+  // Must be called with interrupts disabled (or from `handleEventTimer()`).
+  void armEventTimer() {
+    if (timeEvents.isEmpty()) return;
+    int32_t delay = timeEvents.peek().time - ::micros();
+    delay = constrain(delay, 1, (int32_t)maxEventTimerDelay);
+    eventTimer.begin(handleEventTimer, delay);
   }
 
   void update() {
@@ -85,21 +98,8 @@ namespace TimerLib {
     }
 
     int scheduleMidi(lua_State *L) {
-      int availableEventIndex = -1;
-      for (byte i = 0; i < MAX_EVENTS; i++) {
-        if (events[i].data == 0) {
-          availableEventIndex = i;
-          break;
-        }
-      }
-
-      if (availableEventIndex == -1) {
-        warn("all midi-events in use");
-        lua_pushboolean(L, false);
-        return 1;
-      }
-
-      uint32_t time = luaL_checknumber(L, 1);
+      // Either ticks or ms (which may be fractional for sub-ms precision).
+      lua_Number time = luaL_checknumber(L, 1);
       bool useTicks = lua_toboolean(L, 2);
       byte type = luaL_checkint(L, 3);
       byte data1 = luaL_checkint(L, 4);
@@ -113,31 +113,30 @@ namespace TimerLib {
       uint32_t message = (status << 16) | (data1 << 8) | data2;
       uint32_t data = (message << 8) | (deviceIndex << 4) | cable;
 
-      // To save some space, we store wether to use ticks or ms as a flag in the
-      // most significant bit (32). This bit is already used by the midi message
-      // but only to indicate a status byte (which for the first byte in a midi
-      // message is always the case). We can therefore use it, as long as we
-      // make sure to set it back to 1 before we send the message.
+      // Both queues are dispatched from interrupts.
+      noInterrupts();
+      bool added;
       if (useTicks) {
-        // MSB is already set to 1.
+        added = tickEvents.push(time, data);
       } else {
-        // Set MSB to 0.
-        data = data | ~(1 << 31);
+        uint32_t ms = time;
+        uint32_t us = ms * 1000 + (uint32_t)((time - ms) * 1000);
+        added = timeEvents.push(us, data);
+        if (added) armEventTimer();
       }
+      interrupts();
 
-      MidiEvent midiEvent;
-      midiEvent.time = time;
-      midiEvent.data = data;
-      events[availableEventIndex] = midiEvent;
-
-      lua_pushboolean(L, true);
+      if (!added) warn("all midi-events in use");
+      lua_pushboolean(L, added);
       return 1;
     }
 
     int clearScheduledMidi(lua_State *L) {
-      for (byte i = 0; i < MAX_EVENTS; i++) {
-        events[i].data = 0;
-      }
+      noInterrupts();
+      tickEvents.clear();
+      timeEvents.clear();
+      eventTimer.end();
+      interrupts();
       return 0;
     }
   } // namespace lib
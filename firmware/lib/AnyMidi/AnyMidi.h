@@ -2,13 +2,28 @@
 #define AnyMidi_h
 
 #include <Arduino.h>
+#include <SpscQueue.h>
 
 class AnyMidi {
 public:
+  // A received message, packed as type (8 bits), data1 (7), data2 (7),
+  // channel (5) and cable (4).
+  struct Message {
+    uint32_t time; // μs
+    uint32_t data;
+  };
+  static const uint16_t maxMessages = 64;
+
   byte index;
+  // Messages that didn't fit into the ring and had to be dropped.
+  uint32_t overflows = 0;
+
   typedef void (*InputHandler
   )(byte index, byte type, byte data1, byte data2, byte channel, byte cable);
   InputHandler handleInput;
+  // Returns whether the message was consumed (see `update()`).
+  typedef bool (*ClockHandler)(byte index, byte type, uint32_t time);
+  ClockHandler handleClock;
 
   AnyMidi(byte index) {
     this->index = index;
@@ -16,15 +31,68 @@ public:
 
   virtual void begin(){};
 
-  virtual void update() = 0;
+  // Read everything the transport has into the ring, see `receive()`.
+  virtual void poll() = 0;
+
+  // Pass all messages of the ring on to the handlers. Realtime clock messages
+  // (clock, start, continue, stop) are offered to the clock handler first,
+  // everything else goes to the input handler. Returns the number of messages.
+  uint16_t update() {
+    uint16_t count = 0;
+    Message message;
+    while (messages.pop(message)) {
+      count++;
+      uint32_t data = message.data;
+      byte type = data >> 24;
+      byte data1 = (data >> 17) & 127;
+      byte data2 = (data >> 10) & 127;
+      byte channel = (data >> 4) & 31;
+      byte cable = data & 15;
+
+      bool isClock =
+        type == 0xF8 || type == 0xFA || type == 0xFB || type == 0xFC;
+      if (
+        isClock && handleClock != NULL &&
+        handleClock(index, type, message.time)
+      )
+        continue;
+
+      if (handleInput != NULL)
+        handleInput(index, type, data1, data2, channel, cable);
+    }
+    return count;
+  }
 
   virtual void send(
     byte type, byte data1, byte data2, byte channel, byte cable
   ) = 0;
 
+  // Whether `send()` may be called from an interrupt (e.g. the midi clock).
+  // Messages for other devices are queued and sent from the main loop instead.
+  virtual bool isInterruptSafe() {
+    return false;
+  }
+
   void onInput(InputHandler handler) {
     handleInput = handler;
   }
+
+  void onClock(ClockHandler handler) {
+    handleClock = handler;
+  }
+
+protected:
+  // Called by the drivers right after a message has been read, so the
+  // timestamp is as close to the arrival as possible.
+  void receive(byte type, byte data1, byte data2, byte channel, byte cable) {
+    uint32_t data = ((uint32_t)type << 24) | ((data1 & 127) << 17) |
+      ((data2 & 127) << 10) | ((channel & 31) << 4) | (cable & 15);
+    if (!messages.push({micros(), data})) overflows++;
+  }
+
+private:
+  // Only used from the main loop, but the queue works just as well there.
+  SpscQueue<Message, maxMessages> messages;
 };
 
 #endif
\ No newline at end of file
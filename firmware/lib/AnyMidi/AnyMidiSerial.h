@@ -21,13 +21,13 @@ public:
     midi->turnThruOff();
   }
 
-  void update() {
-    if (midi->read() && handleInput != NULL) {
+  void poll() {
+    while (midi->read()) {
       byte type = midi->getType();
       byte data1 = midi->getData1();
       byte data2 = midi->getData2();
       byte channel = midi->getChannel();
-      handleInput(index, type, data1, data2, channel, 0);
+      receive(type, data1, data2, channel, 0);
     }
   }
 
@@ -81,6 +81,13 @@ public:
   void send(byte type, byte data1, byte data2, byte channel, byte cable) {
     midi->send(getType(type), data1, data2, channel);
   }
+
+  // Sending only fills the serial's transmit buffer, which is safe from an
+  // interrupt as long as the main loop disables interrupts while sending to
+  // the same device (see `MidiLib::send()`).
+  bool isInterruptSafe() {
+    return true;
+  }
 };
 
 #endif
\ No newline at end of file
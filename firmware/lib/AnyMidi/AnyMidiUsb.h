@@ -7,14 +7,14 @@ class AnyMidiUsb : public AnyMidi {
 public:
   AnyMidiUsb(byte index) : AnyMidi(index) {}
 
-  void update() {
-    if (usbMIDI.read() && handleInput != NULL) {
+  void poll() {
+    while (usbMIDI.read()) {
       byte type = usbMIDI.getType();
       byte data1 = usbMIDI.getData1();
       byte data2 = usbMIDI.getData2();
       byte channel = usbMIDI.getChannel();
       byte cable = usbMIDI.getCable();
-      handleInput(index, type, data1, data2, channel, cable);
+      receive(type, data1, data2, channel, cable);
     }
   }
 
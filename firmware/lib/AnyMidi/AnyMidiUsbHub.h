@@ -13,14 +13,14 @@ public:
     this->midi = midi;
   }
 
-  void update() {
-    if (midi->read() && handleInput != NULL) {
+  void poll() {
+    while (midi->read()) {
       byte type = midi->getType();
       byte data1 = midi->getData1();
       byte data2 = midi->getData2();
       byte channel = midi->getChannel();
       byte cable = midi->getCable();
-      handleInput(index, type, data1, data2, channel, cable);
+      receive(type, data1, data2, channel, cable);
     }
   }
 
@@ -0,0 +1,324 @@
+#ifndef Display_h
+#define Display_h
+
+#include <Adafruit_SSD1306.h>
+#include <FontAtlas.h>
+
+/**
+ * A 1-bit image in the display's own memory layout: `(height + 7) / 8` pages
+ * of `width` bytes, the lowest bit of each byte is the topmost pixel.
+ */
+struct Bitmap {
+  uint8_t *data;
+  uint8_t width;
+  uint8_t height;
+};
+
+/**
+ * An SSD1306 display that sends its framebuffer in small chunks instead of all
+ * at once. The Teensy's `Wire` can't transfer in the background, so each
+ * `flushChunk()` is one short i2c transaction (~0.7ms at 400kHz) and the main
+ * loop keeps running in between, instead of blocking for the whole ~12ms.
+ *
+ * All drawing marks the changed columns of each page (a row of 8 pixels) as
+ * dirty. A flush takes a copy of the framebuffer (so drawing can go on while
+ * it is sent) and only sends the dirty bytes that differ from what was sent
+ * last, so redrawing the same content costs no i2c traffic at all.
+ */
+class Display : public Adafruit_SSD1306 {
+private:
+  // Bytes per i2c transaction (including the control byte), fits into the
+  // Wire's transmit buffer.
+  static const uint8_t chunkSize = 32;
+  static const uint8_t maxPages = 8;
+  static const uint8_t maxWidth = 128;
+  // Runs of changed bytes with up to this many unchanged bytes in between are
+  // sent as one, a new address window costs about as much.
+  static const uint8_t maxGap = 6;
+
+  uint8_t frame[maxWidth * maxPages]; // The frame being flushed.
+  uint8_t sent[maxWidth * maxPages];  // What the display shows.
+
+  // The changed columns of each page, `start > end` means the page is clean.
+  uint8_t dirtyStart[maxPages];
+  uint8_t dirtyEnd[maxPages];
+  // The columns being flushed, taken from the dirty ones when a flush starts.
+  uint8_t flushStart[maxPages];
+  uint8_t flushEnd[maxPages];
+
+  uint8_t flushPage = 0;
+  uint8_t flushColumn = 0;
+  uint8_t runStart = 0;
+  uint8_t runEnd = 0;
+  bool needsAddress = false;
+  bool isFlushing = false;
+
+  uint8_t getPages() {
+    return (HEIGHT + 7) / 8;
+  }
+
+  void markClean() {
+    memset(dirtyStart, 255, sizeof(dirtyStart));
+    memset(dirtyEnd, 0, sizeof(dirtyEnd));
+  }
+
+  void markDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    x0 = max(x0, (int16_t)0);
+    y0 = max(y0, (int16_t)0);
+    x1 = min(x1, (int16_t)(WIDTH - 1));
+    y1 = min(y1, (int16_t)(HEIGHT - 1));
+    if (x0 > x1 || y0 > y1) return;
+
+    for (uint8_t page = y0 / 8; page <= y1 / 8; page++) {
+      dirtyStart[page] = min(dirtyStart[page], (uint8_t)x0);
+      dirtyEnd[page] = max(dirtyEnd[page], (uint8_t)x1);
+    }
+  }
+
+  // Apply a column of up to 32 pixels (bit 0 is row `top`) to the
+  // framebuffer. Instead of setting each pixel, the column is shifted into
+  // place and combined with the (up to five) page bytes it spans. Pixels in
+  // `mask` that aren't in `bits` are drawn in the opposite color.
+  void blitColumn(
+    int16_t column, int16_t top, uint32_t bits, uint32_t mask, uint16_t color
+  ) {
+    uint8_t shift = top & 7;
+    int16_t page = (top - shift) / 8;
+    int16_t pages = getPages();
+    uint64_t pixels = (uint64_t)bits << shift;
+    uint64_t masks = (uint64_t)mask << shift;
+
+    for (; pixels | masks; page++, pixels >>= 8, masks >>= 8) {
+      if (page < 0 || page >= pages) continue;
+
+      uint8_t pixel = pixels & 0xFF;
+      uint8_t pixelMask = masks & 0xFF;
+      uint8_t &target = buffer[page * WIDTH + column];
+      switch (color) {
+        case SSD1306_WHITE:
+          target = (target & ~pixelMask) | pixel;
+          break;
+        case SSD1306_BLACK:
+          target = (target | pixelMask) & ~pixel;
+          break;
+        case SSD1306_INVERSE:
+          target ^= pixel;
+          break;
+      }
+    }
+  }
+
+  // Find the next run of changed bytes, starting at `flushPage` and
+  // `flushColumn`. Returns false if there is nothing left to send.
+  bool findRun() {
+    uint8_t pages = getPages();
+    while (flushPage < pages) {
+      uint16_t offset = flushPage * WIDTH;
+      uint16_t end = flushEnd[flushPage];
+      uint16_t column = flushColumn;
+
+      while (column <= end && frame[offset + column] == sent[offset + column])
+        column++;
+
+      if (column <= end) {
+        runStart = runEnd = column;
+        uint8_t gap = 0;
+        for (column++; column <= end; column++) {
+          if (frame[offset + column] != sent[offset + column]) {
+            runEnd = column;
+            gap = 0;
+          } else if (++gap > maxGap) {
+            break;
+          }
+        }
+        return true;
+      }
+
+      flushPage++;
+      if (flushPage < pages) flushColumn = flushStart[flushPage];
+    }
+    return false;
+  }
+
+public:
+  Display(uint8_t width, uint8_t height, TwoWire *wire, int8_t resetPin) :
+    Adafruit_SSD1306(width, height, wire, resetPin) {
+    markClean();
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    Adafruit_SSD1306::drawPixel(x, y, color);
+    markDirty(x, y, x, y);
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t width, uint16_t color) {
+    Adafruit_SSD1306::drawFastHLine(x, y, width, color);
+    markDirty(x, y, x + width - 1, y);
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t height, uint16_t color) {
+    Adafruit_SSD1306::drawFastVLine(x, y, height, color);
+    markDirty(x, y, x, y + height - 1);
+  }
+
+  void clearDisplay() {
+    Adafruit_SSD1306::clearDisplay();
+    markDirty(0, 0, WIDTH - 1, HEIGHT - 1);
+  }
+
+  // Send the whole buffer at once (blocking).
+  void display() {
+    Adafruit_SSD1306::display();
+    memcpy(sent, buffer, WIDTH * getPages());
+    markClean();
+  }
+
+  // Blit text from a glyph atlas, `y` is the baseline. Instead of decoding each
+  // pixel, every glyph column is applied as a whole (see `blitColumn()`).
+  // Columns outside `clipStart`/`clipEnd` are skipped. Returns the x position
+  // after the text.
+  int16_t drawText(
+    const FontAtlas::Font *font,
+    int16_t x,
+    int16_t y,
+    const char *text,
+    uint16_t color,
+    int16_t clipStart = 0,
+    int16_t clipEnd = INT16_MAX
+  ) {
+    clipStart = max(clipStart, (int16_t)0);
+    clipEnd = min(clipEnd, (int16_t)(WIDTH - 1));
+
+    int16_t top = y + font->top;
+    int16_t firstColumn = INT16_MAX;
+    int16_t lastColumn = -1;
+
+    for (; *text; text++) {
+      const FontAtlas::Glyph *glyph = FontAtlas::getGlyph(font, *text);
+      if (glyph == NULL) continue;
+
+      int16_t glyphX = x + glyph->xOffset;
+      x += glyph->xAdvance;
+      if (glyphX > clipEnd || glyphX + glyph->width <= clipStart) continue;
+
+      for (uint8_t i = 0; i < glyph->width; i++) {
+        int16_t column = glyphX + i;
+        if (column < clipStart || column > clipEnd) continue;
+
+        uint32_t bits = font->columns[glyph->offset + i];
+        if (bits == 0) continue;
+        blitColumn(column, top, bits, 0, color);
+        firstColumn = min(firstColumn, column);
+        lastColumn = max(lastColumn, column);
+      }
+    }
+
+    markDirty(firstColumn, top, lastColumn, top + font->height - 1);
+    return x;
+  }
+
+  // Blit (a part of) a bitmap, only its set pixels are drawn unless it is
+  // `opaque`. A `width` or `height` of zero means up to the bitmap's edge.
+  void blit(
+    const Bitmap &bitmap,
+    int16_t x,
+    int16_t y,
+    uint16_t color,
+    bool opaque = false,
+    uint8_t sourceX = 0,
+    uint8_t sourceY = 0,
+    uint8_t width = 0,
+    uint8_t height = 0
+  ) {
+    if (sourceX >= bitmap.width || sourceY >= bitmap.height) return;
+    uint8_t maxWidth = bitmap.width - sourceX;
+    uint8_t maxHeight = bitmap.height - sourceY;
+    width = width == 0 ? maxWidth : min(width, maxWidth);
+    height = height == 0 ? maxHeight : min(height, maxHeight);
+
+    uint32_t mask = height >= 32 ? UINT32_MAX : (1UL << height) - 1;
+    uint8_t pages = (bitmap.height + 7) / 8;
+    int16_t start = max(x, (int16_t)0);
+    int16_t end = min((int16_t)(x + width - 1), (int16_t)(WIDTH - 1));
+
+    for (int16_t column = start; column <= end; column++) {
+      const uint8_t *data = bitmap.data + sourceX + (column - x);
+      uint64_t bits = 0;
+      for (uint8_t page = 0; page < pages; page++)
+        bits |= (uint64_t)data[page * bitmap.width] << (page * 8);
+
+      bits = (bits >> sourceY) & mask;
+      blitColumn(column, y, bits, opaque ? mask : 0, color);
+    }
+
+    markDirty(start, y, end, y + height - 1);
+  }
+
+  // Copy a part of the framebuffer into the bitmap, e.g. to draw something
+  // with the primitives once and blit it from then on.
+  void capture(Bitmap &bitmap, int16_t x, int16_t y) {
+    memset(bitmap.data, 0, bitmap.width * ((bitmap.height + 7) / 8));
+    for (uint8_t i = 0; i < bitmap.width; i++) {
+      for (uint8_t j = 0; j < bitmap.height; j++) {
+        if (getPixel(x + i, y + j))
+          bitmap.data[(j / 8) * bitmap.width + i] |= 1 << (j & 7);
+      }
+    }
+  }
+
+  bool getIsFlushing() {
+    return isFlushing;
+  }
+
+  void startFlush() {
+    memcpy(frame, buffer, WIDTH * getPages());
+    memcpy(flushStart, dirtyStart, sizeof(flushStart));
+    memcpy(flushEnd, dirtyEnd, sizeof(flushEnd));
+    markClean();
+
+    flushPage = 0;
+    flushColumn = flushStart[0];
+    needsAddress = true;
+    isFlushing = findRun();
+  }
+
+  // Send the next chunk, returns whether there is more to send. Each run of
+  // changed bytes starts with a (short) transaction that sets the address
+  // window.
+  bool flushChunk() {
+    if (!isFlushing) return false;
+
+    wire->setClock(wireClk);
+    if (needsAddress) {
+      uint8_t commands[] = {
+        SSD1306_PAGEADDR,
+        flushPage,
+        flushPage,
+        SSD1306_COLUMNADDR,
+        runStart,
+        runEnd};
+      ssd1306_commandList(commands, sizeof(commands));
+      flushColumn = runStart;
+      needsAddress = false;
+    } else {
+      uint8_t count = min(chunkSize - 1, runEnd - flushColumn + 1);
+      uint16_t offset = flushPage * WIDTH + flushColumn;
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x40); // Co = 0, D/C = 1
+      wire->write(frame + offset, count);
+      wire->endTransmission();
+      memcpy(sent + offset, frame + offset, count);
+
+      flushColumn += count;
+      if (flushColumn > runEnd) {
+        needsAddress = true;
+        isFlushing = findRun();
+      }
+    }
+    wire->setClock(restoreClk);
+
+    return isFlushing;
+  }
+};
+
+#endif
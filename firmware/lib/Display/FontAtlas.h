@@ -0,0 +1,44 @@
+#ifndef FontAtlas_h
+#define FontAtlas_h
+
+#include <Arduino.h>
+
+/**
+ * A font converted (by `scripts/font_atlas.py`) into columns of pixels, so
+ * text can be blitted a whole column at a time (see `Display::drawText()`).
+ */
+namespace FontAtlas {
+  struct Glyph {
+    uint16_t offset; // Index of the glyph's first column.
+    uint8_t width;
+    uint8_t xAdvance;
+    int8_t xOffset;
+  };
+
+  struct Font {
+    // One word per column, bit 0 is the row `top` (relative to the baseline).
+    const uint32_t *columns;
+    const Glyph *glyphs;
+    uint16_t first;
+    uint16_t last;
+    int8_t top;
+    uint8_t height;
+  };
+
+  const Glyph *getGlyph(const Font *font, char c) {
+    uint8_t code = c;
+    if (code < font->first || code > font->last) return NULL;
+    return &font->glyphs[code - font->first];
+  }
+
+  uint16_t measure(const Font *font, const char *text) {
+    uint16_t width = 0;
+    for (; *text; text++) {
+      const Glyph *glyph = getGlyph(font, *text);
+      if (glyph != NULL) width += glyph->xAdvance;
+    }
+    return width;
+  }
+} // namespace FontAtlas
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef EventQueue_h
+#define EventQueue_h
+
+#include <Arduino.h>
+
+/**
+ * A fixed-capacity binary min-heap of timed events. Insertion is O(log n) and
+ * taking all due events is O(due * log n), so the queue never has to be
+ * scanned. Events with the same time are returned in insertion order. Times
+ * are compared wrap-around safe (like `micros()`), as long as all events lie
+ * within 2^31 of each other.
+ */
+template <uint16_t capacity> class EventQueue {
+public:
+  struct Event {
+    uint32_t time;
+    uint32_t data;
+    uint32_t sequence;
+  };
+
+private:
+  Event events[capacity];
+  uint16_t count = 0;
+  uint32_t nextSequence = 0;
+
+  static bool isBefore(const Event &a, const Event &b) {
+    if (a.time != b.time) return (int32_t)(a.time - b.time) < 0;
+    return (int32_t)(a.sequence - b.sequence) < 0;
+  }
+
+  void siftUp(uint16_t index) {
+    Event event = events[index];
+    while (index > 0) {
+      uint16_t parent = (index - 1) / 2;
+      if (!isBefore(event, events[parent])) break;
+      events[index] = events[parent];
+      index = parent;
+    }
+    events[index] = event;
+  }
+
+  void siftDown(uint16_t index) {
+    Event event = events[index];
+    while (true) {
+      uint16_t child = index * 2 + 1;
+      if (child >= count) break;
+      if (child + 1 < count && isBefore(events[child + 1], events[child]))
+        child++;
+      if (!isBefore(events[child], event)) break;
+      events[index] = events[child];
+      index = child;
+    }
+    events[index] = event;
+  }
+
+public:
+  bool push(uint32_t time, uint32_t data) {
+    if (count >= capacity) return false;
+    events[count] = {time, data, nextSequence++};
+    siftUp(count++);
+    return true;
+  }
+
+  // Remove the earliest event if it is due at `time`.
+  bool popDue(uint32_t time, Event &event) {
+    if (count == 0 || (int32_t)(events[0].time - time) > 0) return false;
+
+    event = events[0];
+    events[0] = events[--count];
+    if (count > 0) siftDown(0);
+    return true;
+  }
+
+  const Event &peek() const {
+    return events[0];
+  }
+
+  uint16_t size() const {
+    return count;
+  }
+
+  bool isEmpty() const {
+    return count == 0;
+  }
+
+  bool isFull() const {
+    return count >= capacity;
+  }
+
+  void clear() {
+    count = 0;
+  }
+};
+
+#endif
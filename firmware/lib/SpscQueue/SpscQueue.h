@@ -0,0 +1,50 @@
+#ifndef SpscQueue_h
+#define SpscQueue_h
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * A lock-free single-producer/single-consumer ring buffer, used to hand data
+ * from an interrupt to the main loop without disabling interrupts. `push()`
+ * must only be called from the producer and `pop()` only from the consumer.
+ * `capacity` must be a power of two, one slot is always kept free.
+ */
+template <typename T, uint16_t capacity> class SpscQueue {
+  static_assert(
+    (capacity & (capacity - 1)) == 0, "capacity must be a power of two"
+  );
+
+private:
+  static const uint16_t mask = capacity - 1;
+  T items[capacity];
+  std::atomic<uint16_t> head{0}; // Written by the producer.
+  std::atomic<uint16_t> tail{0}; // Written by the consumer.
+
+public:
+  bool push(const T &item) {
+    uint16_t currentHead = head.load(std::memory_order_relaxed);
+    uint16_t nextHead = (currentHead + 1) & mask;
+    if (nextHead == tail.load(std::memory_order_acquire)) return false;
+
+    items[currentHead] = item;
+    head.store(nextHead, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &item) {
+    uint16_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail == head.load(std::memory_order_acquire)) return false;
+
+    item = items[currentTail];
+    tail.store((currentTail + 1) & mask, std::memory_order_release);
+    return true;
+  }
+
+  bool isEmpty() const {
+    return tail.load(std::memory_order_acquire) ==
+      head.load(std::memory_order_acquire);
+  }
+};
+
+#endif
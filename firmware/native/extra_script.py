@@ -0,0 +1,10 @@
+Import("env")
+
+# Lua's rotables pass c function pointers through `lua_Number` (float), which
+# only works for small addresses like the Teensy's ITCM. Build a position
+# dependent executable so the host's code addresses stay small too.
+env.Append(
+    CCFLAGS=["-fno-pie"],
+    CXXFLAGS=["-std=gnu++17"],
+    LINKFLAGS=["-no-pie", "-pthread"],
+)
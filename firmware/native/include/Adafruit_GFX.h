@@ -0,0 +1,394 @@
+#ifndef Adafruit_GFX_h
+#define Adafruit_GFX_h
+
+#include "Print.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Minimal port of the Adafruit GFX library, covering the primitives and the
+ * custom font rendering the firmware uses. The algorithms follow the original
+ * so rasterization cost is comparable.
+ */
+typedef struct {
+  uint16_t bitmapOffset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t xAdvance;
+  int8_t xOffset;
+  int8_t yOffset;
+} GFXglyph;
+
+typedef struct {
+  uint8_t *bitmap;
+  GFXglyph *glyph;
+  uint16_t first;
+  uint16_t last;
+  uint8_t yAdvance;
+} GFXfont;
+
+class Adafruit_GFX : public Print {
+protected:
+  int16_t WIDTH;
+  int16_t HEIGHT;
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x = 0;
+  int16_t cursor_y = 0;
+  uint16_t textcolor = 0xFFFF;
+  uint16_t textbgcolor = 0xFFFF;
+  bool wrap = true;
+  GFXfont *gfxFont = NULL;
+
+  template <typename T> static void swap(T &a, T &b) {
+    T t = a;
+    a = b;
+    b = t;
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color) {
+    c -= gfxFont->first;
+    GFXglyph *glyph = gfxFont->glyph + c;
+    uint8_t *bitmap = gfxFont->bitmap;
+
+    uint16_t bo = glyph->bitmapOffset;
+    uint8_t w = glyph->width, h = glyph->height;
+    int8_t xo = glyph->xOffset, yo = glyph->yOffset;
+    uint8_t bits = 0, bit = 0;
+
+    for (uint8_t yy = 0; yy < h; yy++) {
+      for (uint8_t xx = 0; xx < w; xx++) {
+        if (!(bit++ & 7)) bits = bitmap[bo++];
+        if (bits & 0x80) drawPixel(x + xo + xx, y + yo + yy, color);
+        bits <<= 1;
+      }
+    }
+  }
+
+  void drawCircleHelper(
+    int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint16_t color
+  ) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+      if (cornername & 0x4) {
+        drawPixel(x0 + x, y0 + y, color);
+        drawPixel(x0 + y, y0 + x, color);
+      }
+      if (cornername & 0x2) {
+        drawPixel(x0 + x, y0 - y, color);
+        drawPixel(x0 + y, y0 - x, color);
+      }
+      if (cornername & 0x8) {
+        drawPixel(x0 - y, y0 + x, color);
+        drawPixel(x0 - x, y0 + y, color);
+      }
+      if (cornername & 0x1) {
+        drawPixel(x0 - y, y0 - x, color);
+        drawPixel(x0 - x, y0 - y, color);
+      }
+    }
+  }
+
+  void fillCircleHelper(
+    int16_t x0,
+    int16_t y0,
+    int16_t r,
+    uint8_t corners,
+    int16_t delta,
+    uint16_t color
+  ) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    int16_t px = x;
+    int16_t py = y;
+
+    delta++;
+
+    while (x < y) {
+      if (f >= 0) {
+        y--;
+        ddF_y += 2;
+        f += ddF_y;
+      }
+      x++;
+      ddF_x += 2;
+      f += ddF_x;
+      if (x < (y + 1)) {
+        if (corners & 1) drawFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+        if (corners & 2) drawFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+      if (y != py) {
+        if (corners & 1) drawFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+        if (corners & 2) drawFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+        py = y;
+      }
+      px = x;
+    }
+  }
+
+public:
+  Adafruit_GFX(int16_t w, int16_t h) :
+    WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+  }
+
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+  }
+
+  virtual void fillRect(
+    int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color
+  ) {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+  }
+
+  virtual void fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+  }
+
+  void drawLine(
+    int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color
+  ) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+      swap(x0, y0);
+      swap(x1, y1);
+    }
+    if (x0 > x1) {
+      swap(x0, x1);
+      swap(y0, y1);
+    }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = y0 < y1 ? 1 : -1;
+
+    for (; x0 <= x1; x0++) {
+      if (steep) {
+        drawPixel(y0, x0, color);
+      } else {
+        drawPixel(x0, y0, color);
+      }
+      err -= dy;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    drawPixel(x0, y0 + r, color);
+    drawPixel(x0, y0 - r, color);
+    drawPixel(x0 + r, y0, color);
+    drawPixel(x0 - r, y0, color);
+    drawCircleHelper(x0, y0, r, 0xF, color);
+  }
+
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(x0, y0, r, 3, 0, color);
+  }
+
+  void drawRoundRect(
+    int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color
+  ) {
+    int16_t maxRadius = ((w < h) ? w : h) / 2;
+    if (r > maxRadius) r = maxRadius;
+    drawFastHLine(x + r, y, w - 2 * r, color);
+    drawFastHLine(x + r, y + h - 1, w - 2 * r, color);
+    drawFastVLine(x, y + r, h - 2 * r, color);
+    drawFastVLine(x + w - 1, y + r, h - 2 * r, color);
+    drawCircleHelper(x + r, y + r, r, 1, color);
+    drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+    drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+  }
+
+  void fillRoundRect(
+    int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color
+  ) {
+    int16_t maxRadius = ((w < h) ? w : h) / 2;
+    if (r > maxRadius) r = maxRadius;
+    fillRect(x + r, y, w - 2 * r, h, color);
+    fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+    fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+  }
+
+  void drawTriangle(
+    int16_t x0,
+    int16_t y0,
+    int16_t x1,
+    int16_t y1,
+    int16_t x2,
+    int16_t y2,
+    uint16_t color
+  ) {
+    drawLine(x0, y0, x1, y1, color);
+    drawLine(x1, y1, x2, y2, color);
+    drawLine(x2, y2, x0, y0, color);
+  }
+
+  void fillTriangle(
+    int16_t x0,
+    int16_t y0,
+    int16_t x1,
+    int16_t y1,
+    int16_t x2,
+    int16_t y2,
+    uint16_t color
+  ) {
+    int16_t a, b, y, last;
+
+    if (y0 > y1) {
+      swap(y0, y1);
+      swap(x0, x1);
+    }
+    if (y1 > y2) {
+      swap(y2, y1);
+      swap(x2, x1);
+    }
+    if (y0 > y1) {
+      swap(y0, y1);
+      swap(x0, x1);
+    }
+
+    if (y0 == y2) {
+      a = b = x0;
+      if (x1 < a) {
+        a = x1;
+      } else if (x1 > b) {
+        b = x1;
+      }
+      if (x2 < a) {
+        a = x2;
+      } else if (x2 > b) {
+        b = x2;
+      }
+      drawFastHLine(a, y0, b - a + 1, color);
+      return;
+    }
+
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0,
+            dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+
+    last = y1 == y2 ? y1 : y1 - 1;
+
+    for (y = y0; y <= last; y++) {
+      a = x0 + sa / dy01;
+      b = x0 + sb / dy02;
+      sa += dx01;
+      sb += dx02;
+      if (a > b) swap(a, b);
+      drawFastHLine(a, y, b - a + 1, color);
+    }
+
+    sa = (int32_t)dx12 * (y - y1);
+    sb = (int32_t)dx02 * (y - y0);
+    for (; y <= y2; y++) {
+      a = x1 + sa / dy12;
+      b = x0 + sb / dy02;
+      sa += dx12;
+      sb += dx02;
+      if (a > b) swap(a, b);
+      drawFastHLine(a, y, b - a + 1, color);
+    }
+  }
+
+  void setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+  }
+
+  int16_t getCursorX() const {
+    return cursor_x;
+  }
+
+  int16_t getCursorY() const {
+    return cursor_y;
+  }
+
+  void setTextColor(uint16_t color) {
+    textcolor = textbgcolor = color;
+  }
+
+  void setTextColor(uint16_t color, uint16_t background) {
+    textcolor = color;
+    textbgcolor = background;
+  }
+
+  void setTextWrap(bool wrap) {
+    this->wrap = wrap;
+  }
+
+  void setFont(const GFXfont *font) {
+    gfxFont = (GFXfont *)font;
+  }
+
+  int16_t width() const {
+    return _width;
+  }
+
+  int16_t height() const {
+    return _height;
+  }
+
+  // Only custom (GFXfont) fonts are supported, the firmware never uses the
+  // built-in 5x7 font.
+  size_t write(uint8_t c) {
+    if (gfxFont == NULL) return 1;
+
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += gfxFont->yAdvance;
+    } else if (c != '\r') {
+      if (c >= gfxFont->first && c <= gfxFont->last) {
+        GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+        uint8_t w = glyph->width, h = glyph->height;
+        if (w > 0 && h > 0) {
+          int16_t xo = glyph->xOffset;
+          if (wrap && (cursor_x + (xo + w)) > _width) {
+            cursor_x = 0;
+            cursor_y += gfxFont->yAdvance;
+          }
+          drawChar(cursor_x, cursor_y, c, textcolor);
+        }
+        cursor_x += glyph->xAdvance;
+      }
+    }
+    return 1;
+  }
+
+  using Print::write;
+};
+
+#endif
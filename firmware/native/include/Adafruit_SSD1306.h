@@ -0,0 +1,143 @@
+#ifndef Adafruit_SSD1306_h
+#define Adafruit_SSD1306_h
+
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_EXTERNALVCC 0x01
+#define SSD1306_SWITCHCAPVCC 0x02
+
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+/**
+ * Port of the Adafruit SSD1306 driver on top of the simulated `TwoWire`. The
+ * framebuffer layout and the i2c transfer sequence of `display()` match the
+ * original, so a flush blocks for as long as it would on the device.
+ */
+class Adafruit_SSD1306 : public Adafruit_GFX {
+protected:
+  TwoWire *wire;
+  uint8_t *buffer = NULL;
+  uint8_t i2caddr = 0;
+  uint32_t wireClk = 400000;
+  uint32_t restoreClk = 100000;
+
+  // The Teensy's Wire buffer holds 32 bytes (including the address).
+  static const uint8_t wireMax = 32;
+
+  void ssd1306_commandList(const uint8_t *commands, uint8_t count) {
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x00); // Co = 0, D/C = 0
+    uint16_t bytesOut = 1;
+    while (count--) {
+      if (bytesOut >= wireMax) {
+        wire->endTransmission();
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x00);
+        bytesOut = 1;
+      }
+      wire->write(*commands++);
+      bytesOut++;
+    }
+    wire->endTransmission();
+  }
+
+public:
+  Adafruit_SSD1306(
+    uint8_t w,
+    uint8_t h,
+    TwoWire *wire,
+    int8_t resetPin = -1,
+    uint32_t clkDuring = 400000,
+    uint32_t clkAfter = 100000
+  ) :
+    Adafruit_GFX(w, h), wire(wire), wireClk(clkDuring), restoreClk(clkAfter) {}
+
+  ~Adafruit_SSD1306() {
+    delete[] buffer;
+  }
+
+  bool begin(
+    uint8_t switchvcc = SSD1306_SWITCHCAPVCC,
+    uint8_t i2caddr = 0,
+    bool reset = true,
+    bool periphBegin = true
+  ) {
+    if (buffer == NULL) buffer = new uint8_t[WIDTH * ((HEIGHT + 7) / 8)];
+    clearDisplay();
+    this->i2caddr = i2caddr;
+    if (periphBegin) wire->begin();
+    return true;
+  }
+
+  void ssd1306_command(uint8_t command) {
+    ssd1306_commandList(&command, 1);
+  }
+
+  void display() {
+    wire->setClock(wireClk);
+
+    static const uint8_t commands[] = {
+      SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0};
+    ssd1306_commandList(commands, sizeof(commands));
+    ssd1306_command(WIDTH - 1);
+
+    uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+    uint8_t *ptr = buffer;
+
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);
+    uint16_t bytesOut = 1;
+    while (count--) {
+      if (bytesOut >= wireMax) {
+        wire->endTransmission();
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x40);
+        bytesOut = 1;
+      }
+      wire->write(*ptr++);
+      bytesOut++;
+    }
+    wire->endTransmission();
+
+    wire->setClock(restoreClk);
+  }
+
+  void clearDisplay() {
+    memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return;
+
+    uint8_t *byte = &buffer[x + (y / 8) * WIDTH];
+    switch (color) {
+      case SSD1306_WHITE:
+        *byte |= (1 << (y & 7));
+        break;
+      case SSD1306_BLACK:
+        *byte &= ~(1 << (y & 7));
+        break;
+      case SSD1306_INVERSE:
+        *byte ^= (1 << (y & 7));
+        break;
+    }
+  }
+
+  bool getPixel(int16_t x, int16_t y) {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return false;
+    return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+  }
+
+  uint8_t *getBuffer() {
+    return buffer;
+  }
+};
+
+#endif
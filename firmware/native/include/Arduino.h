@@ -0,0 +1,102 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+#include "HardwareSerial.h"
+#include "Native.h"
+#include "Print.h"
+#include "Stream.h"
+#include "usb_midi.h"
+#include "usb_serial.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_pointer(address) (*(void *const *)(address))
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+
+template <class A, class B>
+inline typename std::common_type<A, B>::type min(A a, B b) {
+  return a < b ? a : b;
+}
+
+template <class A, class B>
+inline typename std::common_type<A, B>::type max(A a, B b) {
+  return a > b ? a : b;
+}
+
+#define constrain(amount, low, high)                                           \
+  ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+inline uint32_t millis() {
+  return Native::microsSinceStart() / 1000;
+}
+
+inline uint32_t micros() {
+  return Native::microsSinceStart();
+}
+
+inline void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(uint32_t us) {
+  Native::busyWait(us);
+}
+
+inline void yield() {}
+
+inline void noInterrupts() {
+  Native::interruptLock.lock();
+}
+
+inline void interrupts() {
+  Native::interruptLock.unlock();
+}
+
+// There is no real hardware attached, inputs read as idle (buttons use
+// `INPUT_PULLUP`, so idle is `HIGH`) and outputs are ignored.
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline int digitalRead(uint8_t pin) {
+  return HIGH;
+}
+inline void digitalWrite(uint8_t pin, uint8_t value) {}
+inline void analogWrite(uint8_t pin, int value) {}
+inline void analogWriteResolution(uint32_t bits) {}
+inline void analogWriteFrequency(uint8_t pin, float frequency) {}
+
+class CrashReportClass : public Printable {
+public:
+  size_t printTo(Print &p) const {
+    return 0;
+  }
+
+  operator bool() {
+    return false;
+  }
+};
+
+inline CrashReportClass CrashReport;
+
+#endif
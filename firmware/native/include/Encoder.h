@@ -0,0 +1,22 @@
+#ifndef Encoder_h
+#define Encoder_h
+
+#include <stdint.h>
+
+class Encoder {
+private:
+  int32_t position = 0;
+
+public:
+  Encoder(uint8_t pin1, uint8_t pin2) {}
+
+  int32_t read() {
+    return position;
+  }
+
+  void write(int32_t position) {
+    this->position = position;
+  }
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include "Stream.h"
+#include <string>
+
+/**
+ * A hardware serial port. Bytes aren't simulated, serial midi input is scripted
+ * per port on message level instead (see `MIDI.h`).
+ */
+class HardwareSerial : public Stream {
+public:
+  const std::string name;
+
+  HardwareSerial(const char *name) : name(name) {}
+
+  void begin(uint32_t baud) {}
+
+  int available() {
+    return 0;
+  }
+
+  int read() {
+    return -1;
+  }
+
+  int peek() {
+    return -1;
+  }
+
+  size_t write(uint8_t b) {
+    return 1;
+  }
+
+  using Print::write;
+};
+
+inline HardwareSerial Serial1("serial1");
+inline HardwareSerial Serial2("serial2");
+inline HardwareSerial Serial3("serial3");
+inline HardwareSerial Serial4("serial4");
+inline HardwareSerial Serial5("serial5");
+inline HardwareSerial Serial6("serial6");
+inline HardwareSerial Serial7("serial7");
+inline HardwareSerial Serial8("serial8");
+
+#endif
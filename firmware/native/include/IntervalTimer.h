@@ -0,0 +1,60 @@
+#ifndef IntervalTimer_h
+#define IntervalTimer_h
+
+#include "Native.h"
+#include <atomic>
+
+/**
+ * Runs the callback on its own thread, holding `Native::interruptLock` like an
+ * interrupt would block the main loop.
+ */
+class IntervalTimer {
+private:
+  std::thread thread;
+  // Each `begin()` starts a new generation, so a callback can restart its own
+  // timer (like a one-shot timer re-armed from its interrupt).
+  std::atomic<uint32_t> generation{0};
+  std::atomic<uint64_t> period{0}; // ns
+  void (*callback)() = NULL;
+
+  void run(uint32_t runGeneration) {
+    auto next = Native::Clock::now();
+    while (generation == runGeneration) {
+      next += std::chrono::nanoseconds(period.load());
+      std::this_thread::sleep_until(next);
+
+      std::lock_guard<std::recursive_mutex> lock(Native::interruptLock);
+      if (generation != runGeneration) break;
+      callback();
+    }
+  }
+
+public:
+  bool begin(void (*callback)(), double microseconds) {
+    end();
+    this->callback = callback;
+    period = microseconds * 1000;
+    thread = std::thread(&IntervalTimer::run, this, generation.load());
+    return true;
+  }
+
+  void update(double microseconds) {
+    period = microseconds * 1000;
+  }
+
+  // The thread isn't joined, it exits on its own once it notices the new
+  // generation. Joining could deadlock if `end()` is called while interrupts
+  // are disabled or from the callback itself.
+  void end() {
+    generation++;
+    if (thread.joinable()) thread.detach();
+  }
+
+  void priority(uint8_t priority) {}
+
+  ~IntervalTimer() {
+    end();
+  }
+};
+
+#endif
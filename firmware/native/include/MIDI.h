@@ -0,0 +1,95 @@
+#ifndef MIDI_h
+#define MIDI_h
+
+#include "HardwareSerial.h"
+#include "Native.h"
+
+#define MIDI_CHANNEL_OMNI 0
+#define MIDI_CHANNEL_OFF 17
+
+/**
+ * Stand-in for the FortySevenEffects midi library. Input is scripted with the
+ * name of the underlying serial port (`serial2`, `serial5`, ...).
+ */
+namespace midi {
+  typedef uint8_t Channel;
+  typedef uint8_t DataByte;
+
+  enum MidiType : uint8_t {
+    InvalidType = 0x00,
+    NoteOff = 0x80,
+    NoteOn = 0x90,
+    AfterTouchPoly = 0xA0,
+    ControlChange = 0xB0,
+    ProgramChange = 0xC0,
+    AfterTouchChannel = 0xD0,
+    PitchBend = 0xE0,
+    SystemExclusive = 0xF0,
+    TimeCodeQuarterFrame = 0xF1,
+    SongPosition = 0xF2,
+    SongSelect = 0xF3,
+    TuneRequest = 0xF6,
+    SystemExclusiveEnd = 0xF7,
+    Clock = 0xF8,
+    Tick = 0xF9,
+    Start = 0xFA,
+    Continue = 0xFB,
+    Stop = 0xFC,
+    ActiveSensing = 0xFE,
+    SystemReset = 0xFF,
+  };
+
+  template <class SerialPort> class SerialMIDI {
+  public:
+    SerialPort &serial;
+
+    SerialMIDI(SerialPort &serial) : serial(serial) {}
+  };
+
+  template <class Transport> class MidiInterface {
+  private:
+    Transport &transport;
+    Native::MidiInput message;
+
+  public:
+    MidiInterface(Transport &transport) : transport(transport) {}
+
+    void begin(Channel channel = 1) {
+      transport.serial.begin(31250);
+    }
+
+    void turnThruOff() {}
+
+    bool read() {
+      return Native::readMidi(transport.serial.name, message);
+    }
+
+    MidiType getType() const {
+      return (MidiType)message.type;
+    }
+
+    Channel getChannel() const {
+      return message.channel;
+    }
+
+    DataByte getData1() const {
+      return message.data1;
+    }
+
+    DataByte getData2() const {
+      return message.data2;
+    }
+
+    void send(MidiType type, DataByte data1, DataByte data2, Channel channel) {
+      Native::writeMidi(transport.serial.name, type, data1, data2, channel, 0);
+    }
+  };
+} // namespace midi
+
+#define MIDI_CREATE_INSTANCE(Type, SerialPort, Name)                            \
+  midi::SerialMIDI<Type> serial##Name(SerialPort);                             \
+  midi::MidiInterface<midi::SerialMIDI<Type>> Name(                            \
+    (midi::SerialMIDI<Type> &)serial##Name                                     \
+  );
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef Native_h
+#define Native_h
+
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <strings.h>
+#include <thread>
+
+/**
+ * Runtime state of the simulated Teensy used by the `native` environment. The
+ * stand-in headers next to this file (`Arduino.h`, `usb_serial.h`, `MIDI.h`,
+ * ...) forward all hardware access to this namespace, which is configured from
+ * the command line (see `native/src/main.cpp`).
+ */
+namespace Native {
+  typedef std::chrono::steady_clock Clock;
+
+  struct MidiInput {
+    uint32_t time; // ms
+    uint8_t type;
+    uint8_t data1;
+    uint8_t data2;
+    uint8_t channel;
+    uint8_t cable;
+  };
+
+  inline Clock::time_point startTime = Clock::now();
+
+  // Held while an `IntervalTimer` callback runs, so `noInterrupts()` in the
+  // main loop behaves like disabling interrupts on the device.
+  inline std::recursive_mutex interruptLock;
+
+  inline std::string sdRoot = "sd";
+  inline FILE *serialInput = NULL;
+  inline FILE *serialOutput = NULL;
+  inline FILE *midiOutput = NULL;
+  inline uint32_t duration = 0; // ms, zero runs forever.
+
+  // Scripted midi input, keyed by port name (`usb`, `serial2`, `hub1`, ...).
+  inline std::map<std::string, std::deque<MidiInput>> midiInputs;
+
+  inline uint64_t microsSinceStart() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+             Clock::now() - startTime
+    )
+      .count();
+  }
+
+  inline void busyWait(uint32_t us) {
+    auto end = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < end) {
+    }
+  }
+
+  inline bool readMidi(const std::string &port, MidiInput &input) {
+    auto it = midiInputs.find(port);
+    if (it == midiInputs.end() || it->second.empty()) return false;
+
+    auto &queue = it->second;
+    if (queue.front().time * 1000ULL > microsSinceStart()) return false;
+
+    input = queue.front();
+    queue.pop_front();
+    return true;
+  }
+
+  inline void writeMidi(
+    const std::string &port,
+    uint8_t type,
+    uint8_t data1,
+    uint8_t data2,
+    uint8_t channel,
+    uint8_t cable
+  ) {
+    if (midiOutput == NULL) return;
+    fprintf(
+      midiOutput,
+      "%llu %s 0x%02X %d %d %d %d\n",
+      (unsigned long long)microsSinceStart(),
+      port.c_str(),
+      type,
+      data1,
+      data2,
+      channel,
+      cable + 1
+    );
+  }
+
+  // Resolve a path on the simulated sd card. FAT is case-insensitive (the
+  // engine relies on that, e.g. `require('Utils')` loads `utils.lua`), so each
+  // path segment that doesn't exist as written is matched ignoring case.
+  inline std::string sdPath(const char *path) {
+    namespace fs = std::filesystem;
+    fs::path resolved = sdRoot;
+
+    for (auto &segment : fs::path(path).relative_path()) {
+      fs::path exact = resolved / segment;
+      std::error_code error;
+      if (fs::exists(exact, error) || !fs::is_directory(resolved, error)) {
+        resolved = exact;
+        continue;
+      }
+
+      std::string name = segment.string();
+      for (auto &entry : fs::directory_iterator(resolved, error)) {
+        std::string entryName = entry.path().filename().string();
+        if (strcasecmp(entryName.c_str(), name.c_str()) == 0) {
+          exact = entry.path();
+          break;
+        }
+      }
+      resolved = exact;
+    }
+
+    return resolved.string();
+  }
+
+  bool begin(int argc, char **argv);
+  bool isRunning();
+  void end();
+} // namespace Native
+
+#endif
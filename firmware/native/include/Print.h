@@ -0,0 +1,143 @@
+#ifndef Print_h
+#define Print_h
+
+#include "Printable.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+#define F(string_literal) ((const __FlashStringHelper *)(string_literal))
+
+class Print {
+private:
+  size_t printNumber(unsigned long long n, uint8_t base, bool sign) {
+    char buffer[66];
+    char *p = &buffer[sizeof(buffer) - 1];
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+      uint8_t digit = n % base;
+      *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+      n /= base;
+    } while (n);
+    if (sign) *--p = '-';
+    return write(p);
+  }
+
+  size_t printSigned(long long n, int base) {
+    if (n < 0 && base == DEC) return printNumber(-n, base, true);
+    return printNumber(n, base, false);
+  }
+
+public:
+  virtual size_t write(uint8_t b) = 0;
+
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t count = 0;
+    while (size--) count += write(*buffer++);
+    return count;
+  }
+
+  size_t write(const char *string) {
+    return write((const uint8_t *)string, strlen(string));
+  }
+
+  virtual int availableForWrite() {
+    return 0;
+  }
+
+  virtual void flush() {}
+
+  size_t print(const char *string) {
+    return write(string);
+  }
+  size_t print(const __FlashStringHelper *string) {
+    return write((const char *)string);
+  }
+  size_t print(char c) {
+    return write((uint8_t)c);
+  }
+  size_t print(uint8_t n, int base = DEC) {
+    return printNumber(n, base, false);
+  }
+  size_t print(int n, int base = DEC) {
+    return printSigned(n, base);
+  }
+  size_t print(unsigned int n, int base = DEC) {
+    return printNumber(n, base, false);
+  }
+  size_t print(long n, int base = DEC) {
+    return printSigned(n, base);
+  }
+  size_t print(unsigned long n, int base = DEC) {
+    return printNumber(n, base, false);
+  }
+  size_t print(long long n, int base = DEC) {
+    return printSigned(n, base);
+  }
+  size_t print(unsigned long long n, int base = DEC) {
+    return printNumber(n, base, false);
+  }
+  size_t print(double n, int digits = 2) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+    return write(buffer);
+  }
+  size_t print(const Printable &printable) {
+    return printable.printTo(*this);
+  }
+
+  size_t println() {
+    return write("\r\n");
+  }
+  template <typename T> size_t println(T value) {
+    return print(value) + println();
+  }
+  template <typename T> size_t println(T value, int format) {
+    return print(value, format) + println();
+  }
+
+  int vprintf(const char *format, va_list args) {
+    char buffer[256];
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(buffer, sizeof(buffer), format, copy);
+    va_end(copy);
+    if (length < 0) return length;
+
+    if ((size_t)length < sizeof(buffer)) {
+      write((const uint8_t *)buffer, length);
+    } else {
+      char *large = new char[length + 1];
+      vsnprintf(large, length + 1, format, args);
+      write((const uint8_t *)large, length);
+      delete[] large;
+    }
+    return length;
+  }
+
+  int printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    int length = vprintf(format, args);
+    va_end(args);
+    return length;
+  }
+
+  int printf(const __FlashStringHelper *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = vprintf((const char *)format, args);
+    va_end(args);
+    return length;
+  }
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef SPI_h
+#define SPI_h
+
+class SPIClass {
+public:
+  void begin() {}
+};
+
+inline SPIClass SPI;
+
+#endif
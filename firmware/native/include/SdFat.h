@@ -0,0 +1,284 @@
+#ifndef SdFat_h
+#define SdFat_h
+
+#include "Native.h"
+#include "Print.h"
+#include <algorithm>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+/**
+ * Stand-in for SdFat, backed by a directory on the host (`--sd`, defaults to
+ * `./sd`). Only the parts of the `FatFile` api used by the firmware are
+ * implemented.
+ */
+typedef int oflag_t;
+typedef Print print_t;
+
+#define O_READ O_RDONLY
+#define O_WRITE O_WRONLY
+#define O_AT_END 0x40000000
+#define FILE_READ O_RDONLY
+#define FILE_WRITE (O_RDWR | O_CREAT | O_AT_END)
+
+#define LS_DATE 1
+#define LS_SIZE 2
+#define LS_R 4
+
+#define FIFO_SDIO 0
+#define DMA_SDIO 1
+
+class SdioConfig {
+public:
+  SdioConfig(uint8_t options = FIFO_SDIO) {}
+};
+
+class FatFile {
+private:
+  FILE *file = NULL;
+  bool isDirectory = false;
+  std::filesystem::path path;
+  std::vector<std::filesystem::path> entries;
+  size_t nextEntry = 0;
+
+  static void listEntries(
+    const std::filesystem::path &path,
+    std::vector<std::filesystem::path> &entries
+  ) {
+    entries.clear();
+    std::error_code error;
+    for (auto &entry : std::filesystem::directory_iterator(path, error)) {
+      entries.push_back(entry.path());
+    }
+    std::sort(entries.begin(), entries.end());
+  }
+
+  static void ls(
+    print_t *pr, const std::filesystem::path &path, uint8_t flags, uint8_t indent
+  ) {
+    std::vector<std::filesystem::path> entries;
+    listEntries(path, entries);
+    for (auto &entry : entries) {
+      for (uint8_t i = 0; i < indent; i++) pr->write(' ');
+      pr->print(entry.filename().c_str());
+
+      bool isDir = std::filesystem::is_directory(entry);
+      if (isDir) pr->write('/');
+      pr->println();
+
+      if (isDir && (flags & LS_R)) ls(pr, entry, flags, indent + 2);
+    }
+  }
+
+  bool openPath(const std::filesystem::path &path, oflag_t oflag) {
+    close();
+    this->path = path;
+
+    if (std::filesystem::is_directory(path)) {
+      isDirectory = true;
+      listEntries(path, entries);
+      nextEntry = 0;
+      return true;
+    }
+
+    bool exists = std::filesystem::exists(path);
+    int access = oflag & O_ACCMODE;
+    const char *mode;
+    if (access == O_RDONLY) {
+      if (!exists) return false;
+      mode = "rb";
+    } else if (exists && !(oflag & O_TRUNC)) {
+      mode = "r+b";
+    } else if (exists || (oflag & O_CREAT)) {
+      mode = "w+b";
+    } else {
+      return false;
+    }
+
+    file = fopen(path.c_str(), mode);
+    if (file != NULL && (oflag & (O_AT_END | O_APPEND))) fseek(file, 0, SEEK_END);
+    return file != NULL;
+  }
+
+public:
+  ~FatFile() {
+    close();
+  }
+
+  bool open(const char *path, oflag_t oflag = O_RDONLY) {
+    return openPath(Native::sdPath(path), oflag);
+  }
+
+  bool open(FatFile *dir, const char *path, oflag_t oflag = O_RDONLY) {
+    return openPath(dir->path / path, oflag);
+  }
+
+  bool openNext(FatFile *dir, oflag_t oflag = O_RDONLY) {
+    if (!dir->isDirectory || dir->nextEntry >= dir->entries.size()) {
+      return false;
+    }
+    return openPath(dir->entries[dir->nextEntry++], oflag);
+  }
+
+  bool close() {
+    if (file != NULL) fclose(file);
+    file = NULL;
+    isDirectory = false;
+    entries.clear();
+    return true;
+  }
+
+  bool isOpen() const {
+    return file != NULL || isDirectory;
+  }
+
+  operator bool() const {
+    return isOpen();
+  }
+
+  bool isDir() const {
+    return isDirectory;
+  }
+
+  bool isFile() const {
+    return file != NULL;
+  }
+
+  bool isHidden() const {
+    std::string name = path.filename().string();
+    return name.size() > 0 && name[0] == '.';
+  }
+
+  size_t getName(char *name, size_t size) {
+    std::string fileName = path.filename().string();
+    size_t length = std::min(fileName.size(), size - 1);
+    memcpy(name, fileName.c_str(), length);
+    name[length] = '\0';
+    return length;
+  }
+
+  int read() {
+    if (file == NULL) return -1;
+    int c = fgetc(file);
+    return c == EOF ? -1 : c;
+  }
+
+  int read(void *buffer, size_t count) {
+    if (file == NULL) return -1;
+    return fread(buffer, 1, count, file);
+  }
+
+  int available() {
+    if (file == NULL) return 0;
+    uint32_t remaining = fileSize() - curPosition();
+    return remaining > INT32_MAX ? INT32_MAX : remaining;
+  }
+
+  size_t write(uint8_t b) {
+    return write(&b, 1);
+  }
+
+  size_t write(const char *string) {
+    return write(string, strlen(string));
+  }
+
+  size_t write(const void *buffer, size_t count) {
+    if (file == NULL) return 0;
+    return fwrite(buffer, 1, count, file);
+  }
+
+  uint32_t fileSize() const {
+    if (file == NULL) return 0;
+    std::error_code error;
+    fflush(file);
+    return std::filesystem::file_size(path, error);
+  }
+
+  // FAT timestamps are in local time with a two second resolution.
+  bool getModifyDateTime(uint16_t *date, uint16_t *time) const {
+    struct stat status;
+    if (!isOpen() || stat(path.c_str(), &status) != 0) return false;
+    struct tm local;
+    localtime_r(&status.st_mtime, &local);
+    *date = ((local.tm_year - 80) << 9) | ((local.tm_mon + 1) << 5) |
+            local.tm_mday;
+    *time = (local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2);
+    return true;
+  }
+
+  uint32_t curPosition() const {
+    return file != NULL ? ftell(file) : 0;
+  }
+
+  bool seekSet(uint32_t position) {
+    return file != NULL && fseek(file, position, SEEK_SET) == 0;
+  }
+
+  void rewind() {
+    if (isDirectory) nextEntry = 0;
+    if (file != NULL) ::rewind(file);
+  }
+
+  bool sync() {
+    return file != NULL && fflush(file) == 0;
+  }
+
+  bool rmRfStar() {
+    std::error_code error;
+    std::filesystem::path path = this->path;
+    close();
+    return std::filesystem::remove_all(path, error) > 0;
+  }
+
+  bool ls(print_t *pr, uint8_t flags = 0, uint8_t indent = 0) {
+    if (!isDirectory) return false;
+    ls(pr, path, flags, indent);
+    return true;
+  }
+};
+
+class SdFat {
+public:
+  bool begin(SdioConfig config) {
+    std::error_code error;
+    std::filesystem::create_directories(Native::sdRoot, error);
+    return std::filesystem::is_directory(Native::sdRoot);
+  }
+
+  bool exists(const char *path) {
+    return std::filesystem::exists(Native::sdPath(path));
+  }
+
+  bool remove(const char *path) {
+    std::string hostPath = Native::sdPath(path);
+    if (std::filesystem::is_directory(hostPath)) return false;
+    std::error_code error;
+    return std::filesystem::remove(hostPath, error);
+  }
+
+  bool rename(const char *oldPath, const char *newPath) {
+    std::error_code error;
+    std::filesystem::rename(
+      Native::sdPath(oldPath), Native::sdPath(newPath), error
+    );
+    return !error;
+  }
+
+  bool mkdir(const char *path, bool pFlag = true) {
+    std::error_code error;
+    std::string hostPath = Native::sdPath(path);
+    if (pFlag) return std::filesystem::create_directories(hostPath, error);
+    return std::filesystem::create_directory(hostPath, error);
+  }
+
+  bool rmdir(const char *path) {
+    std::error_code error;
+    return std::filesystem::remove(Native::sdPath(path), error);
+  }
+};
+
+#endif
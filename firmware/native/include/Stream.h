@@ -0,0 +1,34 @@
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print {
+protected:
+  unsigned long timeout = 1000;
+
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) {
+    this->timeout = timeout;
+  }
+
+  size_t readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length && available()) {
+      int c = read();
+      if (c < 0) break;
+      buffer[count++] = c;
+    }
+    return count;
+  }
+
+  size_t readBytes(uint8_t *buffer, size_t length) {
+    return readBytes((char *)buffer, length);
+  }
+};
+
+#endif
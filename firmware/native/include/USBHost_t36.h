@@ -0,0 +1,70 @@
+#ifndef USBHost_t36_h
+#define USBHost_t36_h
+
+#include "Native.h"
+#include <string>
+
+/**
+ * Stand-in for the Teensy usb host library. Midi devices are named `hub1`,
+ * `hub2`, ... in the order they are constructed.
+ */
+class USBHost {
+public:
+  void begin() {}
+  void Task() {}
+};
+
+class USBHub {
+public:
+  USBHub(USBHost &host) {}
+};
+
+class MIDIDevice {
+private:
+  static inline uint8_t count = 0;
+  std::string name;
+  Native::MidiInput message;
+
+public:
+  MIDIDevice(USBHost &host) : name("hub" + std::to_string(++count)) {}
+
+  bool read(uint8_t channel = 0) {
+    return Native::readMidi(name, message);
+  }
+
+  uint8_t getType() {
+    return message.type;
+  }
+
+  uint8_t getChannel() {
+    return message.channel;
+  }
+
+  uint8_t getData1() {
+    return message.data1;
+  }
+
+  uint8_t getData2() {
+    return message.data2;
+  }
+
+  uint8_t getCable() {
+    return message.cable;
+  }
+
+  void send(
+    uint8_t type,
+    uint8_t data1,
+    uint8_t data2,
+    uint8_t channel,
+    uint8_t cable = 0
+  ) {
+    Native::writeMidi(name, type, data1, data2, channel, cable);
+  }
+
+  void sendRealTime(uint8_t type, uint8_t cable = 0) {
+    Native::writeMidi(name, type, 0, 0, 0, cable);
+  }
+};
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef Wire_h
+#define Wire_h
+
+#include "Native.h"
+#include "Stream.h"
+
+#include <vector>
+
+/**
+ * The display RAM of an SSD1306, fed with everything sent over its bus. Only
+ * the addressing commands are interpreted, which is enough to check what a
+ * (partial) display update would actually show.
+ */
+struct Ssd1306Ram {
+  static const uint8_t width = 128;
+  static const uint8_t pages = 8;
+  uint8_t ram[width * pages] = {0};
+  uint8_t columnStart = 0, columnEnd = width - 1;
+  uint8_t pageStart = 0, pageEnd = pages - 1;
+  uint8_t column = 0, page = 0;
+
+  uint8_t command = 0;
+  uint8_t arguments[2];
+  uint8_t argumentsCount = 0;
+  uint8_t argumentsMissing = 0;
+
+  static uint8_t getArgumentsCount(uint8_t command) {
+    switch (command) {
+      case 0x21: // Column address.
+      case 0x22: // Page address.
+        return 2;
+      case 0x20:
+      case 0x81:
+      case 0x8D:
+      case 0xA8:
+      case 0xD3:
+      case 0xD5:
+      case 0xD9:
+      case 0xDA:
+      case 0xDB:
+        return 1;
+      default:
+        return 0;
+    }
+  }
+
+  void handleCommandByte(uint8_t b) {
+    if (argumentsMissing == 0) {
+      command = b;
+      argumentsCount = 0;
+      argumentsMissing = getArgumentsCount(b);
+    } else {
+      if (argumentsCount < 2) arguments[argumentsCount++] = b;
+      argumentsMissing--;
+    }
+    if (argumentsMissing > 0) return;
+
+    if (command == 0x21) {
+      columnStart = column = arguments[0] % width;
+      columnEnd = arguments[1] % width;
+    } else if (command == 0x22) {
+      pageStart = page = arguments[0] % pages;
+      pageEnd = arguments[1] % pages;
+    }
+  }
+
+  void handleDataByte(uint8_t b) {
+    ram[page * width + column] = b;
+    if (column++ < columnEnd) return;
+    column = columnStart;
+    page = page < pageEnd ? page + 1 : pageStart;
+  }
+
+  void handleTransmission(const std::vector<uint8_t> &bytes) {
+    if (bytes.empty()) return;
+    bool isData = bytes[0] & 0x40;
+    for (size_t i = 1; i < bytes.size(); i++) {
+      isData ? handleDataByte(bytes[i]) : handleCommandByte(bytes[i]);
+    }
+  }
+};
+
+/**
+ * Simulated I2C bus. Nothing is transmitted, but `endTransmission()` blocks for
+ * as long as the transfer would take at the current clock (9 bits per byte,
+ * including the address byte), so display updates cost realistic time. All
+ * transmissions are passed to an SSD1306 model (see `Ssd1306Ram`).
+ */
+class TwoWire : public Stream {
+private:
+  uint32_t clock = 100000;
+  std::vector<uint8_t> transmission;
+
+public:
+  Ssd1306Ram display;
+  uint64_t bytesSent = 0; // Including address bytes.
+
+  void begin() {}
+
+  void setClock(uint32_t frequency) {
+    clock = frequency;
+  }
+
+  void beginTransmission(uint8_t address) {
+    transmission.clear();
+  }
+
+  size_t write(uint8_t b) {
+    transmission.push_back(b);
+    return 1;
+  }
+
+  using Print::write;
+
+  uint8_t endTransmission(bool sendStop = true) {
+    size_t bytes = transmission.size() + 1;
+    Native::busyWait(bytes * 9 * 1000000ULL / clock);
+    bytesSent += bytes;
+    display.handleTransmission(transmission);
+    transmission.clear();
+    return 0;
+  }
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+    return 0;
+  }
+
+  int available() {
+    return 0;
+  }
+
+  int read() {
+    return -1;
+  }
+
+  int peek() {
+    return -1;
+  }
+};
+
+inline TwoWire Wire;
+inline TwoWire Wire1;
+inline TwoWire Wire2;
+
+#endif
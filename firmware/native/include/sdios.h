@@ -0,0 +1,36 @@
+#ifndef sdios_h
+#define sdios_h
+
+#include "SdFat.h"
+
+class StdioStream {
+private:
+  FILE *file = NULL;
+
+public:
+  bool fopen(const char *path, const char *mode) {
+    if (file != NULL) fclose();
+    file = ::fopen(Native::sdPath(path).c_str(), mode);
+    return file != NULL;
+  }
+
+  int fclose() {
+    int result = file != NULL ? ::fclose(file) : EOF;
+    file = NULL;
+    return result;
+  }
+
+  int feof() {
+    return file == NULL || ::feof(file);
+  }
+
+  int ferror() {
+    return file == NULL || ::ferror(file);
+  }
+
+  size_t fread(void *ptr, size_t size, size_t count) {
+    return file != NULL ? ::fread(ptr, size, count, file) : 0;
+  }
+};
+
+#endif
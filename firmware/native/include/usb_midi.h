@@ -0,0 +1,75 @@
+#ifndef usb_midi_h
+#define usb_midi_h
+
+#include "Native.h"
+
+/**
+ * The device's own usb midi port. Input is scripted with port name `usb`.
+ */
+class usb_midi_class {
+private:
+  Native::MidiInput message;
+
+public:
+  enum {
+    InvalidType = 0x00,
+    NoteOff = 0x80,
+    NoteOn = 0x90,
+    AfterTouchPoly = 0xA0,
+    ControlChange = 0xB0,
+    ProgramChange = 0xC0,
+    AfterTouchChannel = 0xD0,
+    PitchBend = 0xE0,
+    SystemExclusive = 0xF0,
+    TimeCodeQuarterFrame = 0xF1,
+    SongPosition = 0xF2,
+    SongSelect = 0xF3,
+    TuneRequest = 0xF6,
+    Clock = 0xF8,
+    Start = 0xFA,
+    Continue = 0xFB,
+    Stop = 0xFC,
+    ActiveSensing = 0xFE,
+    SystemReset = 0xFF
+  };
+
+  bool read(uint8_t channel = 0) {
+    return Native::readMidi("usb", message);
+  }
+
+  uint8_t getType() {
+    return message.type;
+  }
+
+  uint8_t getChannel() {
+    return message.channel;
+  }
+
+  uint8_t getData1() {
+    return message.data1;
+  }
+
+  uint8_t getData2() {
+    return message.data2;
+  }
+
+  uint8_t getCable() {
+    return message.cable;
+  }
+
+  void send(
+    uint8_t type, uint8_t data1, uint8_t data2, uint8_t channel, uint8_t cable
+  ) {
+    Native::writeMidi("usb", type, data1, data2, channel, cable);
+  }
+
+  void sendRealTime(uint8_t type, uint8_t cable = 0) {
+    Native::writeMidi("usb", type, 0, 0, 0, cable);
+  }
+
+  void send_now() {}
+};
+
+inline usb_midi_class usbMIDI;
+
+#endif
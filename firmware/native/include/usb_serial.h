@@ -0,0 +1,73 @@
+#ifndef usb_serial_h
+#define usb_serial_h
+
+#include "Native.h"
+#include "Stream.h"
+
+/**
+ * The usb serial connection to the miwos app. Input is read from the file
+ * passed with `--serial` (raw, SLIP encoded bytes as sent by the app), output
+ * is written to the file passed with `--serial-out`.
+ */
+class usb_serial_class : public Stream {
+private:
+  static const size_t bufferSize = 512;
+  uint8_t buffer[bufferSize];
+  size_t head = 0;
+  size_t tail = 0;
+
+  bool fill() {
+    if (head < tail) return true;
+    if (Native::serialInput == NULL) return false;
+    head = 0;
+    tail = fread(buffer, 1, bufferSize, Native::serialInput);
+    return tail > 0;
+  }
+
+public:
+  void begin(long baud) {}
+
+  int available() {
+    return fill() ? tail - head : 0;
+  }
+
+  int read() {
+    return fill() ? buffer[head++] : -1;
+  }
+
+  int peek() {
+    return fill() ? buffer[head] : -1;
+  }
+
+  size_t write(uint8_t b) {
+    if (Native::serialOutput != NULL) fputc(b, Native::serialOutput);
+    return 1;
+  }
+
+  size_t write(const uint8_t *buffer, size_t size) {
+    if (Native::serialOutput == NULL) return size;
+    return fwrite(buffer, 1, size, Native::serialOutput);
+  }
+
+  using Print::write;
+
+  int availableForWrite() {
+    return bufferSize;
+  }
+
+  void send_now() {
+    if (Native::serialOutput != NULL) fflush(Native::serialOutput);
+  }
+
+  void flush() {
+    send_now();
+  }
+
+  operator bool() {
+    return true;
+  }
+};
+
+inline usb_serial_class Serial;
+
+#endif
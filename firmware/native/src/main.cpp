@@ -0,0 +1,161 @@
+/**
+ * Entry point of the `native` environment. Runs the firmware's `setup()` and
+ * `loop()` as a regular process on the host, driven by scripted inputs:
+ *
+ *   program [--sd <dir>] [--serial <file>] [--serial-out <file>]
+ *           [--midi <file>] [--midi-out <file>] [--displays-out <file>]
+ *           [--duration <ms>]
+ *
+ * --sd          Directory used as the sd card (default `sd`).
+ * --serial      Raw SLIP encoded bytes as they would arrive from the app.
+ * --serial-out  Where to write the bytes the device sends to the app.
+ * --midi        Midi input script, one message per line:
+ *               `<ms> <port> <type> <data1> <data2> <channel> [cable]`
+ *               where port is `usb`, `serial2`, `serial5` or `hub1`-`hub10`.
+ * --midi-out    Log of all sent midi messages (with timestamps in μs).
+ * --displays-out  On exit, write what each display shows and how many bytes
+ *               were sent over its bus.
+ * --duration    Stop after this many ms (default: run forever).
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+void setup();
+void loop();
+
+namespace Native {
+  namespace {
+    FILE *displaysOutput = NULL;
+
+    FILE *openFile(const char *path, const char *mode) {
+      if (!strcmp(path, "-")) return mode[0] == 'r' ? stdin : stdout;
+
+      FILE *file = fopen(path, mode);
+      if (file == NULL) fprintf(stderr, "can't open `%s`\n", path);
+      return file;
+    }
+
+    void writeDisplays() {
+      TwoWire *buses[] = {&Wire, &Wire1, &Wire2};
+      for (byte i = 0; i < 3; i++) {
+        Ssd1306Ram &display = buses[i]->display;
+        fprintf(
+          displaysOutput,
+          "display %d (%llu bytes sent)\n",
+          i + 1,
+          (unsigned long long)buses[i]->bytesSent
+        );
+        // The displays are 128x32, so only the first four pages are visible.
+        for (byte y = 0; y < 32; y++) {
+          for (byte x = 0; x < Ssd1306Ram::width; x++) {
+            bool isOn = display.ram[(y / 8) * Ssd1306Ram::width + x] &
+              (1 << (y & 7));
+            fputc(isOn ? '#' : '.', displaysOutput);
+          }
+          fputc('\n', displaysOutput);
+        }
+      }
+    }
+
+    bool loadMidiScript(const char *path) {
+      FILE *file = openFile(path, "r");
+      if (file == NULL) return false;
+
+      char line[256];
+      while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        unsigned long time;
+        char port[32];
+        char type[8];
+        int data1, data2, channel, cable = 1;
+        int count = sscanf(
+          line,
+          "%lu %31s %7s %d %d %d %d",
+          &time,
+          port,
+          type,
+          &data1,
+          &data2,
+          &channel,
+          &cable
+        );
+
+        if (count < 6) {
+          fprintf(stderr, "invalid midi input `%s`", line);
+          continue;
+        }
+
+        midiInputs[port].push_back(
+          {(uint32_t)time,
+           (uint8_t)strtol(type, NULL, 0),
+           (uint8_t)data1,
+           (uint8_t)data2,
+           (uint8_t)channel,
+           (uint8_t)(cable - 1)}
+        );
+      }
+
+      if (file != stdin) fclose(file);
+      return true;
+    }
+  } // namespace
+
+  bool begin(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+      const char *option = argv[i];
+      const char *value = i + 1 < argc ? argv[++i] : NULL;
+      if (value == NULL) {
+        fprintf(stderr, "missing value for `%s`\n", option);
+        return false;
+      }
+
+      if (!strcmp(option, "--sd")) {
+        sdRoot = value;
+      } else if (!strcmp(option, "--serial")) {
+        serialInput = openFile(value, "rb");
+      } else if (!strcmp(option, "--serial-out")) {
+        serialOutput = openFile(value, "wb");
+      } else if (!strcmp(option, "--midi")) {
+        if (!loadMidiScript(value)) return false;
+      } else if (!strcmp(option, "--midi-out")) {
+        midiOutput = openFile(value, "w");
+      } else if (!strcmp(option, "--displays-out")) {
+        displaysOutput = openFile(value, "w");
+      } else if (!strcmp(option, "--duration")) {
+        duration = strtoul(value, NULL, 10);
+      } else {
+        fprintf(stderr, "unknown option `%s`\n", option);
+        return false;
+      }
+    }
+
+    startTime = Clock::now();
+    return true;
+  }
+
+  bool isRunning() {
+    return duration == 0 || millis() < duration;
+  }
+
+  void end() {
+    if (serialOutput != NULL) fflush(serialOutput);
+    if (midiOutput != NULL) fflush(midiOutput);
+    if (displaysOutput != NULL) {
+      writeDisplays();
+      fflush(displaysOutput);
+    }
+  }
+} // namespace Native
+
+int main(int argc, char **argv) {
+  if (!Native::begin(argc, argv)) return 1;
+
+  setup();
+  while (Native::isRunning()) loop();
+
+  Native::end();
+  // Skip static destructors, the clock timer thread might still be running.
+  _Exit(0);
+}
@@ -0,0 +1,108 @@
+"""
+Generate a glyph atlas from an Adafruit GFX font header, so text can be blitted
+column by column instead of being decoded pixel by pixel (see
+`lib/Display/FontAtlas.h`). Each glyph is stored as one 32 bit word per column,
+bit 0 being the font's topmost row (`top`, relative to the baseline).
+
+Usage: python scripts/font_atlas.py include/fonts/vevey_pixel_12pt.h
+Writes the atlas next to the font (e.g. `vevey_pixel_12pt_atlas.h`).
+"""
+
+import os
+import re
+import sys
+
+HEX = r"0x[0-9a-fA-F]+"
+GLYPH = r"\{\s*" + r",\s*".join([r"(-?\d+)"] * 6) + r"\s*\}"
+
+
+def parse_font(source):
+    bitmap_source = re.search(r"Bitmaps\[\] PROGMEM = \{(.*?)\};", source, re.S)
+    bitmap = [int(value, 16) for value in re.findall(HEX, bitmap_source[1])]
+
+    glyphs_source = re.search(r"Glyphs\[\] PROGMEM = \{(.*?)\n\};", source, re.S)
+    glyphs = [
+        tuple(int(value) for value in match)
+        for match in re.findall(GLYPH, glyphs_source[1])
+    ]
+
+    font = re.search(r"GFXfont \w+ PROGMEM = \{.*?(\w+), (\w+), (\w+)\s*\};", source, re.S)
+    return bitmap, glyphs, int(font[1], 0)
+
+
+def get_columns(bitmap, glyph, top):
+    offset, width, height, _, _, y_offset = glyph
+    columns = [0] * width
+    bit = 0
+    for y in range(height):
+        for x in range(width):
+            if bitmap[offset + bit // 8] & (0x80 >> (bit % 8)):
+                columns[x] |= 1 << (y + y_offset - top)
+            bit += 1
+    return columns
+
+
+def generate(path):
+    with open(path) as file:
+        source = file.read()
+
+    name = os.path.splitext(os.path.basename(path))[0]
+    bitmap, glyphs, first = parse_font(source)
+    # Don't trust the font's `last`, some fonts claim more glyphs than they have.
+    last = first + len(glyphs) - 1
+
+    visible = [glyph for glyph in glyphs if glyph[1] and glyph[2]]
+    top = min(glyph[5] for glyph in visible)
+    bottom = max(glyph[5] + glyph[2] for glyph in visible)
+    if bottom - top > 32:
+        sys.exit(f"{name} is {bottom - top}px high, only 32px are supported")
+
+    columns = []
+    entries = []
+    for index, glyph in enumerate(glyphs):
+        _, width, _, x_advance, x_offset, _ = glyph
+        code = first + index
+        entries.append(
+            f"  {{{len(columns):5}, {width:3}, {x_advance:3}, {x_offset:3}}}, "
+            f"// 0x{code:02x} {chr(code)!r}"
+        )
+        columns.extend(get_columns(bitmap, glyph, top))
+
+    lines = [
+        f"// Generated from `{name}.h` by `scripts/font_atlas.py`.",
+        "",
+        f"#ifndef {name}_atlas_h",
+        f"#define {name}_atlas_h",
+        "",
+        "#include <FontAtlas.h>",
+        "",
+        f"const uint32_t {name}AtlasColumns[] PROGMEM = {{",
+    ]
+    for i in range(0, len(columns), 6):
+        row = columns[i : i + 6]
+        lines.append("  " + ", ".join(f"0x{column:08x}" for column in row) + ",")
+    lines += [
+        "};",
+        "",
+        f"const FontAtlas::Glyph {name}AtlasGlyphs[] PROGMEM = {{",
+        *entries,
+        "};",
+        "",
+        f"const FontAtlas::Font {name}_atlas PROGMEM = {{",
+        f"  {name}AtlasColumns,",
+        f"  {name}AtlasGlyphs,",
+        f"  {first}, {last}, {top}, {bottom - top}",
+        "};",
+        "",
+        "#endif",
+        "",
+    ]
+
+    output = os.path.join(os.path.dirname(path), f"{name}_atlas.h")
+    with open(output, "w") as file:
+        file.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    for path in sys.argv[1:]:
+        generate(path)
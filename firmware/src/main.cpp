@@ -1,8 +1,13 @@
+// Defined before any include, so the headers see them too (e.g. the profiler's
+// loop log, enabled with `DEBUG_LOOP`).
+#define DEBUG
+
 #include <Arduino.h>
 #include <Bridge.h>
 #include <FileSystem.h>
 #include <SlipSerial.h>
 #include <helpers/Lua.h>
+#include <helpers/Profiler.h>
 #include <lua/BridgeLib.h>
 #include <lua/ButtonsLib.h>
 #include <lua/DisplaysLib.h>
@@ -14,15 +19,6 @@
 #include <lua/TimerLib.h>
 #include <lua/UtilsLib.h>
 
-#define DEBUG
-
-#if defined(DEBUG) && defined(DEBUG_LOOP)
-uint32_t lastLoopTime = 0;
-uint32_t maxLoopInterval = 0;
-uint32_t lastLoopLogTime = 0;
-uint32_t loopLogInterval = 1000000;
-#endif
-
 using Bridge::Data;
 using Bridge::RequestId;
 
@@ -82,34 +78,29 @@ void setup() {
     auto number = data.getInt(1);
     Bridge::respond(id, number);
   });
-}
 
-void loop() {
-  Bridge::update();
-  ButtonsLib::update();
-  EncodersLib::update();
-  MidiLib::update();
-  TimerLib::update();
-  DisplaysLib::update();
-
-#if defined(DEBUG) && defined(DEBUG_LOOP)
-  uint32_t now = micros();
-  maxLoopInterval = max(maxLoopInterval, now - lastLoopTime);
+  // Collect the many small messages of each loop (notifications, logs) for up
+  // to 2ms, so they share usb transfers. Only now, so all output of the setup
+  // is sent right away in case it gets stuck.
+  serial.setCoalesceInterval(2000);
+  // Spread big file transfers over several loops, so they don't interrupt
+  // midi, timers and displays.
+  Bridge::setIoBudget(4096);
 
-  if (now - lastLoopLogTime >= loopLogInterval) {
-    const char *color = maxLoopInterval < 100 ? "success"
-      : maxLoopInterval < 500                 ? "warn"
-                                              : "error";
-
-    Logger::beginInfo();
-    Logger::serial->printf(
-      F("{gray Loop interval:} {%s %dμs}\n"), color, maxLoopInterval
-    );
-    Logger::endInfo();
-    lastLoopLogTime = now;
-    maxLoopInterval = 0;
-  }
+  // Start profiling last, so the first loop interval doesn't include setup.
+  Profiler::begin();
+}
 
-  lastLoopTime = now;
-#endif
+void loop() {
+  using namespace Profiler;
+
+  beginLoop();
+  measure(SectionBridge, Bridge::update);
+  measure(SectionButtons, ButtonsLib::update);
+  measure(SectionEncoders, EncodersLib::update);
+  measure(SectionMidi, MidiLib::update);
+  measure(SectionTimer, TimerLib::update);
+  measure(SectionDisplays, DisplaysLib::update);
+  // Catch up on midi input that arrived while the displays were updated.
+  MidiLib::poll();
 }
\ No newline at end of file